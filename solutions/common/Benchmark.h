@@ -0,0 +1,20 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+namespace benchmark {
+
+inline bool is_requested(int argc, char** argv) {
+    return argc > 1 && std::string{argv[1]} == "--benchmark";
+}
+
+template<typename Function>
+double measure_milliseconds(Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <limits>
+#include <cstdint>
+#include <compare>
+#include <concepts>
+#include <type_traits>
+
+// Integer arithmetic which reports overflow instead of wrapping around, and 128-bit products of 64-bit numbers.
+// Compilers with a 128-bit integer type use it, every other compiler gets the same results from 32-bit halves.
+namespace checked_arithmetic {
+
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 NativeDoubleWord;
+#endif
+
+    // Unsigned 128-bit number, the low word comes first in memory as in the native type of little-endian targets.
+    struct DoubleWord {
+        std::uint64_t low = 0;
+        std::uint64_t high = 0;
+
+        constexpr DoubleWord() = default;
+
+        constexpr DoubleWord(std::uint64_t low) : low{low} {}
+
+        constexpr DoubleWord(std::uint64_t high, std::uint64_t low) : low{low}, high{high} {}
+
+        friend constexpr bool operator==(const DoubleWord&, const DoubleWord&) = default;
+
+        friend constexpr std::strong_ordering operator<=>(const DoubleWord& lhs, const DoubleWord& rhs) {
+            if(const std::strong_ordering order = lhs.high <=> rhs.high; order != 0) {
+                return order;
+            }
+            return lhs.low <=> rhs.low;
+        }
+    };
+
+#if defined(__SIZEOF_INT128__)
+    [[nodiscard]]
+    constexpr NativeDoubleWord to_native(DoubleWord value) {
+        return (static_cast<NativeDoubleWord>(value.high) << 64) | value.low;
+    }
+
+    [[nodiscard]]
+    constexpr DoubleWord from_native(NativeDoubleWord value) {
+        return {static_cast<std::uint64_t>(value >> 64), static_cast<std::uint64_t>(value)};
+    }
+#endif
+
+    [[nodiscard]]
+    constexpr DoubleWord multiply_wide(std::uint64_t lhs, std::uint64_t rhs) {
+#if defined(__SIZEOF_INT128__)
+        return from_native(static_cast<NativeDoubleWord>(lhs) * rhs);
+#else
+        constexpr std::uint64_t HALF_MASK = 0xFFFF'FFFF;
+        const std::uint64_t low_low = (lhs & HALF_MASK) * (rhs & HALF_MASK);
+        const std::uint64_t high_low = (lhs >> 32) * (rhs & HALF_MASK);
+        const std::uint64_t low_high = (lhs & HALF_MASK) * (rhs >> 32);
+        const std::uint64_t high_high = (lhs >> 32) * (rhs >> 32);
+        const std::uint64_t middle = (low_low >> 32) + (high_low & HALF_MASK) + low_high;
+        return {high_high + (high_low >> 32) + (middle >> 32), (middle << 32) | (low_low & HALF_MASK)};
+#endif
+    }
+
+    // Returns lhs + rhs + carry modulo 2^64, the carry is 0 or 1 and is replaced by the carry out.
+    [[nodiscard]]
+    constexpr std::uint64_t add_with_carry(std::uint64_t lhs, std::uint64_t rhs, std::uint64_t& carry) {
+        const std::uint64_t partial_sum = lhs + rhs;
+        const std::uint64_t sum = partial_sum + carry;
+        carry = static_cast<std::uint64_t>(partial_sum < lhs) | static_cast<std::uint64_t>(sum < partial_sum);
+        return sum;
+    }
+
+    // Sum modulo 2^128, for callers which know that it does not wrap around.
+    [[nodiscard]]
+    constexpr DoubleWord add_wide(DoubleWord lhs, DoubleWord rhs) {
+#if defined(__SIZEOF_INT128__)
+        return from_native(to_native(lhs) + to_native(rhs));
+#else
+        std::uint64_t carry = 0;
+        const std::uint64_t low = add_with_carry(lhs.low, rhs.low, carry);
+        return {lhs.high + rhs.high + carry, low};
+#endif
+    }
+
+    // Adds the 128-bit product of two factors to the sum, for callers which know that it does not wrap around.
+    [[nodiscard]]
+    constexpr DoubleWord multiply_add(DoubleWord sum, std::uint64_t lhs, std::uint64_t rhs) {
+#if defined(__SIZEOF_INT128__)
+        return from_native(to_native(sum) + static_cast<NativeDoubleWord>(lhs) * rhs);
+#else
+        return add_wide(sum, multiply_wide(lhs, rhs));
+#endif
+    }
+
+    [[nodiscard]]
+    constexpr std::uint64_t remainder(DoubleWord dividend, std::uint64_t divisor) {
+#if defined(__SIZEOF_INT128__)
+        return static_cast<std::uint64_t>(to_native(dividend) % divisor);
+#else
+        // Long division one bit at a time, a bit shifted out of the remainder means it exceeds the divisor.
+        std::uint64_t rest = dividend.high % divisor;
+        for(unsigned bit = 64; bit-- > 0; ) {
+            const bool shifted_out = (rest >> 63) != 0;
+            rest = (rest << 1) | ((dividend.low >> bit) & 1);
+            if(shifted_out || rest >= divisor) {
+                rest -= divisor;
+            }
+        }
+        return rest;
+#endif
+    }
+
+    // Divides the dividend in place and returns the remainder.
+    constexpr std::uint32_t divide(DoubleWord& dividend, std::uint32_t divisor) {
+        std::uint64_t rest = 0;
+        const auto divide_half = [&rest, divisor](std::uint64_t half) {
+            const std::uint64_t current = (rest << 32) | half;
+            rest = current % divisor;
+            return current / divisor;
+        };
+        const std::uint64_t high_high = divide_half(dividend.high >> 32);
+        const std::uint64_t high_low = divide_half(dividend.high & 0xFFFF'FFFF);
+        const std::uint64_t low_high = divide_half(dividend.low >> 32);
+        const std::uint64_t low_low = divide_half(dividend.low & 0xFFFF'FFFF);
+        dividend = {(high_high << 32) | high_low, (low_high << 32) | low_low};
+        return static_cast<std::uint32_t>(rest);
+    }
+
+    // Both functions below store the result and return whether it overflowed, the stored result is then meaningless.
+    template<std::integral Integer>
+    constexpr bool add_overflows(Integer lhs, Integer rhs, Integer& sum) {
+        if constexpr(std::is_unsigned_v<Integer>) {
+            sum = static_cast<Integer>(lhs + rhs);
+            return sum < lhs;
+        }
+        else {
+            if((rhs > 0 && lhs > std::numeric_limits<Integer>::max() - rhs) || (rhs < 0 && lhs < std::numeric_limits<Integer>::min() - rhs)) {
+                return true;
+            }
+            sum = static_cast<Integer>(lhs + rhs);
+            return false;
+        }
+    }
+
+    template<std::integral Integer>
+    constexpr bool multiply_overflows(Integer lhs, Integer rhs, Integer& product) {
+        static_assert(sizeof(Integer) <= sizeof(std::uint64_t), "Only integers of up to 64 bits are supported");
+        using Unsigned = std::make_unsigned_t<Integer>;
+        if constexpr(std::is_unsigned_v<Integer>) {
+            const DoubleWord wide_product = multiply_wide(lhs, rhs);
+            product = static_cast<Integer>(wide_product.low);
+            return wide_product.high != 0 || wide_product.low > std::numeric_limits<Integer>::max();
+        }
+        else {
+            const auto magnitude = [](Integer value) {
+                return value < 0 ? static_cast<Unsigned>(Unsigned{0} - static_cast<Unsigned>(value)) : static_cast<Unsigned>(value);
+            };
+            const bool is_negative = (lhs < 0) != (rhs < 0);
+            const DoubleWord wide_product = multiply_wide(magnitude(lhs), magnitude(rhs));
+            const std::uint64_t largest_magnitude = static_cast<std::uint64_t>(std::numeric_limits<Integer>::max()) + (is_negative ? 1 : 0);
+            if(wide_product.high != 0 || wide_product.low > largest_magnitude) {
+                return true;
+            }
+            const Unsigned product_magnitude = static_cast<Unsigned>(wide_product.low);
+            product = static_cast<Integer>(is_negative ? static_cast<Unsigned>(Unsigned{0} - product_magnitude) : product_magnitude);
+            return false;
+        }
+    }
+
+    constexpr bool add_overflows(DoubleWord lhs, DoubleWord rhs, DoubleWord& sum) {
+#if defined(__SIZEOF_INT128__)
+        NativeDoubleWord native_sum = 0;
+        const bool overflows = __builtin_add_overflow(to_native(lhs), to_native(rhs), &native_sum);
+        sum = from_native(native_sum);
+        return overflows;
+#else
+        std::uint64_t carry = 0;
+        sum.low = add_with_carry(lhs.low, rhs.low, carry);
+        sum.high = add_with_carry(lhs.high, rhs.high, carry);
+        return carry != 0;
+#endif
+    }
+
+    constexpr bool multiply_overflows(DoubleWord lhs, DoubleWord rhs, DoubleWord& product) {
+#if defined(__SIZEOF_INT128__)
+        NativeDoubleWord native_product = 0;
+        const bool overflows = __builtin_mul_overflow(to_native(lhs), to_native(rhs), &native_product);
+        product = from_native(native_product);
+        return overflows;
+#else
+        if(lhs.high != 0 && rhs.high != 0) {
+            return true;
+        }
+        // At most one factor has a high word, its product with the low word of the other one goes into the high word.
+        const std::uint64_t high_factor = lhs.high != 0 ? lhs.high : rhs.high;
+        const std::uint64_t low_factor = lhs.high != 0 ? rhs.low : lhs.low;
+        std::uint64_t cross_product = 0;
+        if(multiply_overflows(high_factor, low_factor, cross_product)) {
+            return true;
+        }
+        product = multiply_wide(lhs.low, rhs.low);
+        return add_overflows(product.high, cross_product, product.high);
+#endif
+    }
+
+}
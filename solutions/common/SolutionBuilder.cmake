@@ -3,7 +3,7 @@ include(CMakeParseArguments)
 function(build_solution_for_given_day)
     cmake_parse_arguments(
             PARSED_ARGS # prefix of output variables
-            "INSTALL_FILE" # list of names of the boolean arguments (only defined ones will be true)
+            "INSTALL_FILE;USE_THREADS" # list of names of the boolean arguments (only defined ones will be true)
             "DAY_NUMBER" # list of names of mono-valued arguments
             "" # list of names of multi-valued arguments (output variables are lists)
             ${ARGN} # arguments of the function to parse, here we take the all original ones
@@ -27,6 +27,11 @@ function(build_solution_for_given_day)
         )
     endif()
 
+    if(PARSED_ARGS_USE_THREADS)
+        find_package(Threads REQUIRED)
+        target_link_libraries(Day${PARSED_ARGS_DAY_NUMBER} PRIVATE Threads::Threads)
+    endif()
+
     if(MSVC)
         target_compile_options(Day${PARSED_ARGS_DAY_NUMBER} PRIVATE /W4 /WX)
     else()
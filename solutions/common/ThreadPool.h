@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <condition_variable>
+
+class ThreadPool {
+public:
+
+    explicit ThreadPool(unsigned number_of_threads = std::thread::hardware_concurrency()) {
+        for(unsigned i = 1; i < std::max(number_of_threads, 1u); ++i) {
+            workers.emplace_back([this]() { run_worker(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+        }
+        work_available.notify_all();
+        for(auto& worker: workers) {
+            worker.join();
+        }
+    }
+
+    [[nodiscard]]
+    inline unsigned size() const {
+        return workers.size() + 1;
+    }
+
+    // Calls task(task_index) for every index in [0, number_of_tasks), the calling thread takes part in the work.
+    // Runs submitted from different threads are executed one after another, tasks must not submit runs themselves.
+    template<typename Task>
+    void run_and_wait(unsigned number_of_tasks, const Task& task) {
+        if(workers.empty() || number_of_tasks <= 1) {
+            for(unsigned task_index = 0; task_index < number_of_tasks; ++task_index) {
+                task(task_index);
+            }
+            return;
+        }
+        std::lock_guard submission_lock{submission_mutex};
+        {
+            std::lock_guard lock{mutex};
+            current_task = &task;
+            current_task_invoker = [](const void* task_to_invoke, unsigned task_index) {
+                (*static_cast<const Task*>(task_to_invoke))(task_index);
+            };
+            current_number_of_tasks = number_of_tasks;
+            next_task_index.store(0);
+            busy_workers = workers.size();
+            first_exception = nullptr;
+            ++generation;
+        }
+        work_available.notify_all();
+        execute_tasks();
+        std::unique_lock lock{mutex};
+        work_finished.wait(lock, [this]() { return busy_workers == 0; });
+        current_task = nullptr;
+        if(first_exception) {
+            std::rethrow_exception(first_exception);
+        }
+    }
+
+private:
+    std::vector<std::thread> workers{};
+    std::mutex submission_mutex{};
+    std::mutex mutex{};
+    std::condition_variable work_available{};
+    std::condition_variable work_finished{};
+    const void* current_task = nullptr;
+    void (*current_task_invoker)(const void*, unsigned) = nullptr;
+    unsigned current_number_of_tasks = 0;
+    std::atomic<unsigned> next_task_index{0};
+    std::size_t busy_workers = 0;
+    std::exception_ptr first_exception{};
+    unsigned long long generation = 0;
+    bool stopping = false;
+
+    void execute_tasks() {
+        for(unsigned task_index = next_task_index++; task_index < current_number_of_tasks; task_index = next_task_index++) {
+            try {
+                current_task_invoker(current_task, task_index);
+            }
+            catch(...) {
+                std::lock_guard lock{mutex};
+                if(!first_exception) {
+                    first_exception = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void run_worker() {
+        unsigned long long seen_generation = 0;
+        while(true) {
+            {
+                std::unique_lock lock{mutex};
+                work_available.wait(lock, [this, seen_generation]() { return stopping || generation != seen_generation; });
+                if(stopping) {
+                    return;
+                }
+                seen_generation = generation;
+            }
+            execute_tasks();
+            std::lock_guard lock{mutex};
+            if(--busy_workers == 0) {
+                work_finished.notify_one();
+            }
+        }
+    }
+};
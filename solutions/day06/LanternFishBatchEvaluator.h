@@ -0,0 +1,198 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <numeric>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <CheckedArithmetic.h>
+#include <LanternFishEngine.h>
+#include <LanternFishTable.h>
+
+// Computes the colony sizes of many initial states after many numbers of days at once.
+// The descendants of one fish are computed once for every distinct number of days, each colony size is then their
+// dot product with the timer counts, which runs in plain 64-bit arithmetic whenever no sum can exceed 64 bits.
+// Numbers of days up to the last day of the precomputed table take their descendants from the table.
+template<typename Arithmetic>
+class LanternFishBatchEvaluator {
+public:
+    using Value = typename Arithmetic::Value;
+
+    explicit LanternFishBatchEvaluator(Arithmetic arithmetic = Arithmetic{}) : engine{arithmetic} {}
+
+    // Colony sizes in row major order, the row of a number of days holds the sizes of all initial states.
+    const std::vector<Value>& evaluate(const std::vector<lantern_fish::TimerCounts>& initial_states, const std::vector<unsigned long long>& days) {
+        store_initial_states(initial_states);
+        results.resize(initial_states.size() * days.size());
+        const Arithmetic& arithmetic = engine.get_arithmetic();
+        ResponseVector descendants{};
+        unsigned long long previous_number_of_days = 0;
+        for_each_distinct_day(days, results.data(), [&](unsigned long long number_of_days, Value* colony_sizes) {
+            const bool has_descendants = number_of_distinct_days != 0;
+            if(number_of_days <= lantern_fish_table::LAST_DAY) {
+                const NarrowResponses table_descendants = to_narrow_responses(lantern_fish_table::DESCENDANT_COUNTS[number_of_days]);
+                for(unsigned timer_value = 0; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+                    descendants[timer_value] = arithmetic.from(table_descendants[timer_value]);
+                }
+                previous_number_of_days = number_of_days;
+                if(fits_into_64_bits(table_descendants)) {
+                    compute_narrow_colony_sizes(table_descendants, colony_sizes);
+                    return;
+                }
+            }
+            else {
+                if(has_descendants && number_of_days - previous_number_of_days <= MAXIMAL_DAYS_TO_ADVANCE) {
+                    descendants = engine.advance_descendants(descendants, number_of_days - previous_number_of_days);
+                }
+                else {
+                    descendants = engine.descendants_of_one_fish(number_of_days);
+                }
+                previous_number_of_days = number_of_days;
+                // Beyond the table only remainders can still fit into 64 bits.
+                if constexpr(std::is_same_v<Value, std::uint64_t>) {
+                    if(fits_into_64_bits(descendants)) {
+                        compute_narrow_colony_sizes(descendants, colony_sizes);
+                        return;
+                    }
+                }
+            }
+            compute_wide_colony_sizes(descendants, colony_sizes);
+        });
+        return results;
+    }
+
+    // Exact colony sizes as 64-bit numbers, which skips the conversion into values of the arithmetic.
+    // As for a table lookup, every number of days has to be in the precomputed table.
+    const std::vector<std::uint64_t>& evaluate_64_bit(const std::vector<lantern_fish::TimerCounts>& initial_states, const std::vector<unsigned long long>& days) {
+        store_initial_states(initial_states);
+        narrow_results.resize(initial_states.size() * days.size());
+        for_each_distinct_day(days, narrow_results.data(), [this](unsigned long long number_of_days, std::uint64_t* colony_sizes) {
+            if(number_of_days > lantern_fish_table::LAST_DAY) {
+                throw std::runtime_error{"Number of days is beyond the precomputed table"};
+            }
+            const NarrowResponses descendants = to_narrow_responses(lantern_fish_table::DESCENDANT_COUNTS[number_of_days]);
+            if(fits_into_64_bits(descendants)) {
+                accumulate_colony_sizes(descendants, colony_sizes, [](std::uint64_t size) { return size; });
+                return;
+            }
+            for(std::size_t state = 0; state < number_of_states; ++state) {
+                std::uint64_t size = 0;
+                for(unsigned timer_value = 0; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+                    std::uint64_t fish = 0;
+                    if(checked_arithmetic::multiply_overflows<std::uint64_t>(states[state][timer_value], descendants[timer_value], fish) ||
+                       checked_arithmetic::add_overflows(size, fish, size)) {
+                        throw std::overflow_error{"Number of fish does not fit into 64 bits"};
+                    }
+                }
+                colony_sizes[state] = size;
+            }
+        });
+        return narrow_results;
+    }
+
+    [[nodiscard]]
+    inline std::size_t get_number_of_distinct_days() const {
+        return number_of_distinct_days;
+    }
+
+private:
+    using ResponseVector = typename LanternFishEngine<Arithmetic>::ResponseVector;
+    using NarrowResponses = std::array<std::uint64_t, lantern_fish::NUMBER_OF_TIMER_VALUES>;
+    // Numbers of days are handled in increasing order, close ones advance the previous descendants day by day,
+    // which is cheaper than a matrix power costing hundreds of multiplications per bit of the number of days.
+    static constexpr unsigned long long MAXIMAL_DAYS_TO_ADVANCE = 256;
+
+    LanternFishEngine<Arithmetic> engine;
+    // Initial states of the current evaluation, which are only read while it runs.
+    const lantern_fish::TimerCounts* states{};
+    std::size_t number_of_states{};
+    // Largest number of fish in one initial state, unless one of them has more than 64 bits.
+    std::uint64_t largest_initial_colony{};
+    bool initial_colonies_fit_into_64_bits{};
+    std::vector<Value> results{};
+    std::vector<std::uint64_t> narrow_results{};
+    std::size_t number_of_distinct_days{};
+
+    template<typename Response>
+    [[nodiscard]]
+    static NarrowResponses to_narrow_responses(const std::array<Response, lantern_fish::NUMBER_OF_TIMER_VALUES>& responses) {
+        NarrowResponses narrow_responses{};
+        std::copy(std::begin(responses), std::end(responses), std::begin(narrow_responses));
+        return narrow_responses;
+    }
+
+    void store_initial_states(const std::vector<lantern_fish::TimerCounts>& initial_states) {
+        states = initial_states.data();
+        number_of_states = initial_states.size();
+        largest_initial_colony = 0;
+        initial_colonies_fit_into_64_bits = true;
+        for(std::size_t state = 0; state < initial_states.size(); ++state) {
+            std::uint64_t initial_colony = 0;
+            for(unsigned timer_value = 0; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+                if(checked_arithmetic::add_overflows<std::uint64_t>(initial_colony, initial_states[state][timer_value], initial_colony)) {
+                    initial_colonies_fit_into_64_bits = false;
+                }
+            }
+            largest_initial_colony = std::max(largest_initial_colony, initial_colony);
+        }
+    }
+
+    // Calls the function once for every distinct number of days in increasing order with the row of its first
+    // occurrence, and copies that row to the rows of all further occurrences.
+    template<typename Result, typename Function>
+    void for_each_distinct_day(const std::vector<unsigned long long>& days, Result* rows, Function function) {
+        std::vector<std::size_t> days_order(days.size());
+        std::iota(std::begin(days_order), std::end(days_order), 0);
+        std::stable_sort(std::begin(days_order), std::end(days_order), [&days](std::size_t lhs, std::size_t rhs) { return days[lhs] < days[rhs]; });
+        number_of_distinct_days = 0;
+        for(std::size_t first = 0; first < days_order.size(); ) {
+            const unsigned long long number_of_days = days[days_order[first]];
+            // Pointer arithmetic instead of dereferencing an iterator, which is past the end when there are no states.
+            Result* const row = rows + days_order[first] * number_of_states;
+            function(number_of_days, row);
+            ++number_of_distinct_days;
+            for(++first; first < days_order.size() && days[days_order[first]] == number_of_days; ++first) {
+                std::copy(row, row + number_of_states, rows + days_order[first] * number_of_states);
+            }
+        }
+    }
+
+    // No dot product exceeds the largest initial colony times the largest response, then 64-bit sums are enough.
+    [[nodiscard]]
+    bool fits_into_64_bits(const NarrowResponses& descendants) const {
+        const std::uint64_t largest_response = *std::max_element(std::begin(descendants), std::end(descendants));
+        std::uint64_t largest_colony = 0;
+        return initial_colonies_fit_into_64_bits && !checked_arithmetic::multiply_overflows(largest_initial_colony, largest_response, largest_colony);
+    }
+
+    // Every size is converted as soon as it is computed, so the row is written once.
+    template<typename Result, typename Conversion>
+    void accumulate_colony_sizes(const NarrowResponses& descendants, Result* colony_sizes, Conversion conversion) const {
+        for(std::size_t state = 0; state < number_of_states; ++state) {
+            std::uint64_t size = 0;
+            for(unsigned timer_value = 0; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+                size += states[state][timer_value] * descendants[timer_value];
+            }
+            colony_sizes[state] = conversion(size);
+        }
+    }
+
+    void compute_narrow_colony_sizes(const NarrowResponses& descendants, Value* colony_sizes) const {
+        const Arithmetic& arithmetic = engine.get_arithmetic();
+        accumulate_colony_sizes(descendants, colony_sizes, [&arithmetic](std::uint64_t size) { return arithmetic.from(size); });
+    }
+
+    void compute_wide_colony_sizes(const ResponseVector& descendants, Value* colony_sizes) const {
+        const Arithmetic& arithmetic = engine.get_arithmetic();
+        for(std::size_t state = 0; state < number_of_states; ++state) {
+            Value size = 0;
+            for(unsigned timer_value = 0; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+                size = arithmetic.add(size, arithmetic.multiply(arithmetic.from(states[state][timer_value]), descendants[timer_value]));
+            }
+            colony_sizes[state] = size;
+        }
+    }
+};
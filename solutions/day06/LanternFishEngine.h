@@ -0,0 +1,207 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#include <CheckedArithmetic.h>
+
+namespace lantern_fish {
+
+    constexpr unsigned NEW_FISH_STARTING_TIMER_VALUE{8};
+    constexpr unsigned FISH_TIMER_RESET_VALUE{6};
+    constexpr unsigned NUMBER_OF_TIMER_VALUES{NEW_FISH_STARTING_TIMER_VALUE + 1};
+
+    using TimerCounts = std::array<unsigned long long, NUMBER_OF_TIMER_VALUES>;
+
+    inline TimerCounts count_timer_values(const std::vector<unsigned>& fish_timers) {
+        TimerCounts timer_counts{};
+        for(const unsigned fish_timer: fish_timers) {
+            if(fish_timer >= NUMBER_OF_TIMER_VALUES) {
+                throw std::runtime_error{"Invalid fish timer value " + std::to_string(fish_timer)};
+            }
+            ++timer_counts[fish_timer];
+        }
+        return timer_counts;
+    }
+
+    // Exact counts, which throw when they do not fit into 128 bits.
+    struct WideArithmetic {
+        using Value = checked_arithmetic::DoubleWord;
+
+        [[nodiscard]]
+        inline Value add(Value lhs, Value rhs) const {
+            Value sum = 0;
+            if(checked_arithmetic::add_overflows(lhs, rhs, sum)) {
+                throw std::overflow_error{"Number of fish does not fit into 128 bits"};
+            }
+            return sum;
+        }
+
+        [[nodiscard]]
+        inline Value multiply(Value lhs, Value rhs) const {
+            Value product = 0;
+            if(checked_arithmetic::multiply_overflows(lhs, rhs, product)) {
+                throw std::overflow_error{"Number of fish does not fit into 128 bits"};
+            }
+            return product;
+        }
+
+        [[nodiscard]]
+        inline Value from(unsigned long long value) const {
+            return value;
+        }
+    };
+
+    // Counts modulo any modulus of up to 64 bits, which never overflow.
+    class ModularArithmetic {
+    public:
+        using Value = std::uint64_t;
+
+        explicit ModularArithmetic(Value modulus) : modulus{modulus} {
+            if(modulus == 0) {
+                throw std::runtime_error{"Modulus has to be positive"};
+            }
+        }
+
+        // Both values are remainders, so their sum exceeds the modulus by less than the modulus, possibly wrapping around.
+        // The modulus is subtracted through a mask, a branch on the comparison would be mispredicted half of the time.
+        [[nodiscard]]
+        inline Value add(Value lhs, Value rhs) const {
+            const Value sum = lhs + rhs;
+            const Value wrap_mask = Value{0} - static_cast<Value>(sum < lhs || sum >= modulus);
+            return sum - (modulus & wrap_mask);
+        }
+
+        [[nodiscard]]
+        inline Value multiply(Value lhs, Value rhs) const {
+            return checked_arithmetic::remainder(checked_arithmetic::multiply_wide(lhs, rhs), modulus);
+        }
+
+        [[nodiscard]]
+        inline Value from(unsigned long long value) const {
+            return value % modulus;
+        }
+
+        [[nodiscard]]
+        inline Value get_modulus() const {
+            return modulus;
+        }
+
+    private:
+        Value modulus{};
+    };
+
+    inline std::string to_string(WideArithmetic::Value value) {
+        if(value == 0) {
+            return "0";
+        }
+        std::string digits{};
+        while(value != 0) {
+            const std::uint32_t digit = checked_arithmetic::divide(value, 10);
+            digits.insert(std::begin(digits), static_cast<char>('0' + digit));
+        }
+        return digits;
+    }
+
+}
+
+// Computes the size of a lanternfish colony after any number of days.
+// A day is a linear map on the counts of fish per timer value, so the counts after n days are the 9x9 transition
+// matrix to the power of n applied to the initial counts, which takes one squaring of the matrix per bit of n.
+template<typename Arithmetic>
+class LanternFishEngine {
+public:
+    using Value = typename Arithmetic::Value;
+    using Matrix = std::array<std::array<Value, lantern_fish::NUMBER_OF_TIMER_VALUES>, lantern_fish::NUMBER_OF_TIMER_VALUES>;
+    using ResponseVector = std::array<Value, lantern_fish::NUMBER_OF_TIMER_VALUES>;
+
+    explicit LanternFishEngine(Arithmetic arithmetic = Arithmetic{}) : arithmetic{arithmetic} {
+        for(unsigned timer_value = 1; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+            transition_matrix[timer_value - 1][timer_value] = arithmetic.from(1);
+        }
+        transition_matrix[lantern_fish::FISH_TIMER_RESET_VALUE][0] = arithmetic.from(1);
+        transition_matrix[lantern_fish::NEW_FISH_STARTING_TIMER_VALUE][0] = arithmetic.from(1);
+    }
+
+    [[nodiscard]]
+    Value colony_size(const lantern_fish::TimerCounts& timer_counts, unsigned long long number_of_days) const {
+        const ResponseVector descendants = descendants_of_one_fish(number_of_days);
+        Value size = 0;
+        for(unsigned timer_value = 0; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+            size = arithmetic.add(size, arithmetic.multiply(arithmetic.from(timer_counts[timer_value]), descendants[timer_value]));
+        }
+        return size;
+    }
+
+    // The colony size is linear in the timer counts, entry t is the number of fish descending from one fish with timer t.
+    [[nodiscard]]
+    ResponseVector descendants_of_one_fish(unsigned long long number_of_days) const {
+        const Matrix power = matrix_power(number_of_days);
+        ResponseVector descendants{};
+        for(unsigned timer_value = 0; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+            for(unsigned new_timer_value = 0; new_timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++new_timer_value) {
+                descendants[timer_value] = arithmetic.add(descendants[timer_value], power[new_timer_value][timer_value]);
+            }
+        }
+        return descendants;
+    }
+
+    // Moves the descendants of one fish the given number of days further, one day at a time.
+    [[nodiscard]]
+    ResponseVector advance_descendants(ResponseVector descendants, unsigned long long number_of_days) const {
+        for(unsigned long long day = 0; day < number_of_days; ++day) {
+            const Value new_fish = arithmetic.add(descendants[lantern_fish::FISH_TIMER_RESET_VALUE], descendants[lantern_fish::NEW_FISH_STARTING_TIMER_VALUE]);
+            for(unsigned timer_value = lantern_fish::NEW_FISH_STARTING_TIMER_VALUE; timer_value > 0; --timer_value) {
+                descendants[timer_value] = descendants[timer_value - 1];
+            }
+            descendants[0] = new_fish;
+        }
+        return descendants;
+    }
+
+    [[nodiscard]]
+    inline const Arithmetic& get_arithmetic() const {
+        return arithmetic;
+    }
+
+private:
+    Arithmetic arithmetic;
+    Matrix transition_matrix{};
+
+    [[nodiscard]]
+    Matrix multiply(const Matrix& lhs, const Matrix& rhs) const {
+        Matrix product{};
+        for(unsigned row = 0; row < lantern_fish::NUMBER_OF_TIMER_VALUES; ++row) {
+            for(unsigned inner = 0; inner < lantern_fish::NUMBER_OF_TIMER_VALUES; ++inner) {
+                if(lhs[row][inner] == 0) {
+                    continue;
+                }
+                for(unsigned column = 0; column < lantern_fish::NUMBER_OF_TIMER_VALUES; ++column) {
+                    product[row][column] = arithmetic.add(product[row][column], arithmetic.multiply(lhs[row][inner], rhs[inner][column]));
+                }
+            }
+        }
+        return product;
+    }
+
+    [[nodiscard]]
+    Matrix matrix_power(unsigned long long exponent) const {
+        Matrix power{};
+        for(unsigned timer_value = 0; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+            power[timer_value][timer_value] = arithmetic.from(1);
+        }
+        Matrix base = transition_matrix;
+        for(; exponent != 0; exponent >>= 1) {
+            if(exponent & 1) {
+                power = multiply(power, base);
+            }
+            if(exponent > 1) {
+                base = multiply(base, base);
+            }
+        }
+        return power;
+    }
+};
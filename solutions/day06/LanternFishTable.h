@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <stdexcept>
+
+#include <CheckedArithmetic.h>
+#include <LanternFishEngine.h>
+
+// Number of fish descending from one fish with a given timer value after every number of days up to LAST_DAY,
+// computed by the compiler. The size of a colony is then the sum of nine products, whatever its initial state.
+namespace lantern_fish_table {
+
+    // The last day on which the descendants of one fish fit into 64 bits, any later day fails to compile.
+    constexpr unsigned LAST_DAY{505};
+
+    using DescendantCounts = std::array<std::array<unsigned long long, lantern_fish::NUMBER_OF_TIMER_VALUES>, LAST_DAY + 1>;
+
+    // A fish with timer value t > 0 behaves as a fish with timer value t - 1 one day later,
+    // a fish with timer value 0 turns into a fish with the reset value and a new fish.
+    constexpr DescendantCounts compute_descendant_counts() {
+        DescendantCounts descendant_counts{};
+        descendant_counts[0].fill(1);
+        for(unsigned day = 1; day <= LAST_DAY; ++day) {
+            const auto& previous_day = descendant_counts[day - 1];
+            for(unsigned timer_value = 1; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+                descendant_counts[day][timer_value] = previous_day[timer_value - 1];
+            }
+            const unsigned long long reset_fish = previous_day[lantern_fish::FISH_TIMER_RESET_VALUE];
+            const unsigned long long new_fish = previous_day[lantern_fish::NEW_FISH_STARTING_TIMER_VALUE];
+            if(checked_arithmetic::add_overflows(reset_fish, new_fish, descendant_counts[day][0])) {
+                throw std::overflow_error{"Number of fish does not fit into 64 bits"};
+            }
+        }
+        return descendant_counts;
+    }
+
+    inline constexpr DescendantCounts DESCENDANT_COUNTS = compute_descendant_counts();
+
+    inline unsigned long long colony_size(const lantern_fish::TimerCounts& timer_counts, unsigned number_of_days) {
+        if(number_of_days > LAST_DAY) {
+            throw std::runtime_error{"Number of days is beyond the precomputed table"};
+        }
+        const auto& descendants = DESCENDANT_COUNTS[number_of_days];
+        unsigned long long size = 0;
+        for(unsigned timer_value = 0; timer_value < lantern_fish::NUMBER_OF_TIMER_VALUES; ++timer_value) {
+            unsigned long long fish = 0;
+            if(checked_arithmetic::multiply_overflows(timer_counts[timer_value], descendants[timer_value], fish) ||
+               checked_arithmetic::add_overflows(size, fish, size)) {
+                throw std::overflow_error{"Number of fish does not fit into 64 bits"};
+            }
+        }
+        return size;
+    }
+
+}
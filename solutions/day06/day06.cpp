@@ -2,11 +2,16 @@
 #include <iostream>
 #include <vector>
 #include <numeric>
+#include <random>
 
 #include <Utils.h>
+#include <Benchmark.h>
+#include <LanternFishEngine.h>
+#include <LanternFishTable.h>
+#include <LanternFishBatchEvaluator.h>
 
-constexpr unsigned NEW_FISH_STARTING_TIMER_VALUE{8};
-constexpr unsigned FISH_TIMER_RESET_VALUE{6};
+using lantern_fish::NEW_FISH_STARTING_TIMER_VALUE;
+using lantern_fish::FISH_TIMER_RESET_VALUE;
 
 std::vector<unsigned> read_puzzle_input(const std::string& file_name) {
     std::ifstream file{file_name};
@@ -34,9 +39,113 @@ long long int calculate_lantern_fish_colony_size(const std::vector<unsigned>& in
     return std::accumulate(std::begin(fish_timer_value_counts), std::end(fish_timer_value_counts),0ll);
 }
 
-int main() {
+void report_matrix_power(const std::vector<unsigned>& initial_state) {
+    const auto timer_counts = lantern_fish::count_timer_values(initial_state);
+    const LanternFishEngine<lantern_fish::WideArithmetic> wide_engine{};
+    for(const unsigned number_of_days: {80u, 256u, 440u, 900u}) {
+        lantern_fish::WideArithmetic::Value size = 0;
+        double time = benchmark::measure_milliseconds([&]() { size = wide_engine.colony_size(timer_counts, number_of_days); });
+        std::cout << "Days: " << number_of_days << ", 128-bit colony size: " << lantern_fish::to_string(size) << ", time: " << time << " ms";
+        if(number_of_days <= 256) {
+            std::cout << ", day by day: " << calculate_lantern_fish_colony_size(initial_state, number_of_days);
+        }
+        std::cout << std::endl;
+    }
+    const LanternFishEngine<lantern_fish::ModularArithmetic> modular_engine{lantern_fish::ModularArithmetic{1'000'000'007}};
+    for(const unsigned long long number_of_days: {900ULL, 1'000'000ULL, 1'000'000'000'000'000'000ULL}) {
+        lantern_fish::ModularArithmetic::Value size = 0;
+        double time = benchmark::measure_milliseconds([&]() { size = modular_engine.colony_size(timer_counts, number_of_days); });
+        std::cout << "Days: " << number_of_days << ", colony size modulo " << modular_engine.get_arithmetic().get_modulus() << ": " << size
+                  << ", time: " << time << " ms" << std::endl;
+    }
+}
+
+void report_table_lookup() {
+    constexpr unsigned NUMBER_OF_QUERIES = 1'000'000;
+    constexpr unsigned NUMBER_OF_ENGINE_QUERIES = 10'000;
+    std::mt19937 generator{2021};
+    std::uniform_int_distribution<unsigned> fish_distribution{0, 1'000};
+    std::uniform_int_distribution<unsigned> day_distribution{0, 256};
+    std::vector<std::pair<lantern_fish::TimerCounts, unsigned>> queries(NUMBER_OF_QUERIES);
+    for(auto& [timer_counts, number_of_days]: queries) {
+        for(auto& timer_count: timer_counts) {
+            timer_count = fish_distribution(generator);
+        }
+        number_of_days = day_distribution(generator);
+    }
+    unsigned long long table_checksum = 0;
+    double table_time = benchmark::measure_milliseconds([&]() {
+        for(const auto& [timer_counts, number_of_days]: queries) {
+            table_checksum += lantern_fish_table::colony_size(timer_counts, number_of_days);
+        }
+    });
+    const LanternFishEngine<lantern_fish::WideArithmetic> engine{};
+    unsigned mismatches = 0;
+    double engine_time = benchmark::measure_milliseconds([&]() {
+        for(unsigned query = 0; query < NUMBER_OF_ENGINE_QUERIES; ++query) {
+            const auto& [timer_counts, number_of_days] = queries[query];
+            mismatches += engine.colony_size(timer_counts, number_of_days) != lantern_fish_table::colony_size(timer_counts, number_of_days);
+        }
+    });
+    std::cout << "Table lookup: " << table_time * 1e6 / NUMBER_OF_QUERIES << " ns per query, checksum: " << table_checksum << std::endl;
+    std::cout << "Matrix power: " << engine_time * 1e6 / NUMBER_OF_ENGINE_QUERIES << " ns per query including the lookup, mismatches: "
+              << mismatches << std::endl;
+}
+
+void report_batch_evaluation() {
+    constexpr unsigned NUMBER_OF_STATES = 20'000;
+    constexpr unsigned NUMBER_OF_DAYS = 64;
+    std::mt19937 generator{2021};
+    std::uniform_int_distribution<unsigned> fish_distribution{0, 1'000};
+    std::uniform_int_distribution<unsigned> day_distribution{0, 256};
+    std::vector<lantern_fish::TimerCounts> initial_states(NUMBER_OF_STATES);
+    for(auto& timer_counts: initial_states) {
+        for(auto& timer_count: timer_counts) {
+            timer_count = fish_distribution(generator);
+        }
+    }
+    std::vector<unsigned long long> days(NUMBER_OF_DAYS);
+    for(auto& number_of_days: days) {
+        number_of_days = day_distribution(generator);
+    }
+    LanternFishBatchEvaluator<lantern_fish::WideArithmetic> evaluator{};
+    const std::vector<lantern_fish::WideArithmetic::Value>* sizes = &evaluator.evaluate(initial_states, days);
+    double batch_time = benchmark::measure_milliseconds([&]() { sizes = &evaluator.evaluate(initial_states, days); });
+    const std::vector<std::uint64_t>* narrow_sizes = &evaluator.evaluate_64_bit(initial_states, days);
+    double narrow_batch_time = benchmark::measure_milliseconds([&]() { narrow_sizes = &evaluator.evaluate_64_bit(initial_states, days); });
+    std::vector<std::uint64_t> table_sizes(initial_states.size() * days.size());
+    double table_time = benchmark::measure_milliseconds([&]() {
+        for(std::size_t day = 0; day < days.size(); ++day) {
+            for(std::size_t state = 0; state < initial_states.size(); ++state) {
+                table_sizes[day * initial_states.size() + state] = lantern_fish_table::colony_size(initial_states[state], days[day]);
+            }
+        }
+    });
+    unsigned mismatches = 0;
+    for(std::size_t query = 0; query < table_sizes.size(); ++query) {
+        mismatches += (*sizes)[query] != table_sizes[query] || (*narrow_sizes)[query] != table_sizes[query];
+    }
+    const double queries_per_nanosecond = 1e-6 * NUMBER_OF_STATES * NUMBER_OF_DAYS;
+    std::cout << "Batch of " << NUMBER_OF_STATES << " states and " << NUMBER_OF_DAYS << " day counts, " << evaluator.get_number_of_distinct_days()
+              << " distinct: " << batch_time / queries_per_nanosecond << " ns per query, 64-bit output: " << narrow_batch_time / queries_per_nanosecond
+              << " ns per query, table lookup: " << table_time / queries_per_nanosecond << " ns per query, mismatches: " << mismatches << std::endl;
+    LanternFishBatchEvaluator<lantern_fish::ModularArithmetic> modular_evaluator{lantern_fish::ModularArithmetic{1'000'000'007}};
+    const std::vector<unsigned long long> many_days{1'000'000ULL, 1'000'000'000'000ULL, 1'000'000'000'000'000'000ULL};
+    double modular_time = benchmark::measure_milliseconds([&]() { modular_evaluator.evaluate(initial_states, many_days); });
+    std::cout << "Modular batch of " << NUMBER_OF_STATES << " states and " << many_days.size() << " day counts up to 10^18: "
+              << modular_time << " ms" << std::endl;
+}
+
+int main(int argc, char** argv) {
     const auto puzzle_input = read_puzzle_input("input.txt");
-    std::cout << "Part 1: " << calculate_lantern_fish_colony_size(puzzle_input, 80) << std::endl;
-    std::cout << "Part 2: " << calculate_lantern_fish_colony_size(puzzle_input, 256) << std::endl;
+    LanternFishBatchEvaluator<lantern_fish::WideArithmetic> evaluator{};
+    const auto& colony_sizes = evaluator.evaluate({lantern_fish::count_timer_values(puzzle_input)}, {80, 256});
+    std::cout << "Part 1: " << lantern_fish::to_string(colony_sizes.at(0)) << std::endl;
+    std::cout << "Part 2: " << lantern_fish::to_string(colony_sizes.at(1)) << std::endl;
+    if(benchmark::is_requested(argc, argv)) {
+        report_matrix_power(puzzle_input);
+        report_table_lookup();
+        report_batch_evaluation();
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include <ThreadPool.h>
+#include <CheckedArithmetic.h>
+#include <PolymerPairEngine.h>
+
+// Jumps any number of pair insertion steps ahead from the current pair counts of an engine.
+// A step is a linear map on the pair counts, so the counts after n steps are the step matrix to the power of n
+// applied to them, which takes one squaring of the matrix per bit of n. Counts after millions of steps have
+// hundreds of thousands of bits, so all counts are kept modulo a modulus of at most 61 bits. With a modulus larger
+// than the true counts the results are exact. Squarings are split into square tiles computed on a thread pool.
+class PolymerFastForward {
+public:
+    using Count = std::uint64_t;
+    using DoubleCount = checked_arithmetic::DoubleWord;
+    static constexpr Count DEFAULT_MODULUS = (Count{1} << 61) - 1;
+
+    explicit PolymerFastForward(const PolymerPairEngine& engine, Count modulus = DEFAULT_MODULUS,
+                                unsigned number_of_threads = std::thread::hardware_concurrency()) :
+        modulus{modulus},
+        number_of_pairs{engine.get_number_of_pairs()},
+        number_of_elements{static_cast<unsigned>(engine.get_elements().size())},
+        last_element{engine.get_last_element()},
+        thread_pool{number_of_threads > 1 ? std::make_unique<ThreadPool>(number_of_threads) : nullptr},
+        step_matrix(static_cast<std::size_t>(number_of_pairs) * number_of_pairs, 0),
+        squared_matrix(step_matrix.size(), 0) {
+        if(modulus < 2 || modulus > MAXIMAL_MODULUS) {
+            throw std::runtime_error{"Modulus has to be between 2 and 2^61"};
+        }
+        const auto& transitions = engine.get_transitions();
+        for(unsigned pair = 0; pair < number_of_pairs; ++pair) {
+            const auto [left_pair, right_pair] = transitions[pair];
+            add_entry(left_pair, pair);
+            if(right_pair < number_of_pairs) {
+                add_entry(right_pair, pair);
+            }
+        }
+        const auto& engine_pair_counts = engine.get_pair_counts();
+        pair_counts.resize(number_of_pairs);
+        for(unsigned pair = 0; pair < number_of_pairs; ++pair) {
+            pair_counts[pair] = engine_pair_counts[pair] % modulus;
+        }
+    }
+
+    // Counts of every element modulo the modulus, in the order of the elements of the engine.
+    [[nodiscard]]
+    std::vector<Count> count_elements_after(unsigned long long number_of_steps) {
+        std::vector<Count> counts = pair_counts;
+        std::vector<Count> power = step_matrix;
+        for(; number_of_steps != 0; number_of_steps >>= 1) {
+            if(number_of_steps & 1) {
+                counts = multiply_vector(power, counts);
+            }
+            if(number_of_steps > 1) {
+                square(power);
+            }
+        }
+        std::vector<Count> element_counts(number_of_elements, 0);
+        for(unsigned pair = 0; pair < number_of_pairs; ++pair) {
+            Count& element_count = element_counts[pair / number_of_elements];
+            element_count = (element_count + counts[pair]) % modulus;
+        }
+        element_counts[last_element] = (element_counts[last_element] + 1) % modulus;
+        return element_counts;
+    }
+
+    [[nodiscard]]
+    inline Count get_modulus() const {
+        return modulus;
+    }
+
+    [[nodiscard]]
+    inline unsigned get_number_of_threads() const {
+        return thread_pool ? thread_pool->size() : 1;
+    }
+
+private:
+    static constexpr Count MAXIMAL_MODULUS = Count{1} << 61;
+    // Products of two residues take at most 122 bits, so a tile of 32 of them and a residue add up without overflow.
+    static constexpr unsigned TILE_SIZE = 32;
+
+    Count modulus{};
+    unsigned number_of_pairs{};
+    unsigned number_of_elements{};
+    unsigned last_element{};
+    std::unique_ptr<ThreadPool> thread_pool{};
+    // Row major, the entry in row to and column from is the number of pairs to created from one pair from.
+    std::vector<Count> step_matrix{};
+    std::vector<Count> squared_matrix{};
+    std::vector<Count> pair_counts{};
+
+    void add_entry(unsigned to, unsigned from) {
+        Count& entry = step_matrix[static_cast<std::size_t>(to) * number_of_pairs + from];
+        entry = (entry + 1) % modulus;
+    }
+
+    [[nodiscard]]
+    std::vector<Count> multiply_vector(const std::vector<Count>& matrix, const std::vector<Count>& counts) const {
+        std::vector<Count> product(number_of_pairs, 0);
+        for(unsigned row = 0; row < number_of_pairs; ++row) {
+            const Count* matrix_row = matrix.data() + static_cast<std::size_t>(row) * number_of_pairs;
+            DoubleCount sum = 0;
+            for(unsigned column = 0; column < number_of_pairs; ++column) {
+                sum = checked_arithmetic::multiply_add(sum, matrix_row[column], counts[column]);
+                if(column % TILE_SIZE == TILE_SIZE - 1) {
+                    sum = checked_arithmetic::remainder(sum, modulus);
+                }
+            }
+            product[row] = checked_arithmetic::remainder(sum, modulus);
+        }
+        return product;
+    }
+
+    void square(std::vector<Count>& matrix) {
+        const unsigned tiles_per_side = (number_of_pairs + TILE_SIZE - 1) / TILE_SIZE;
+        const auto tile_task = [&](unsigned tile_index) {
+            multiply_tile(matrix, matrix, tile_index / tiles_per_side, tile_index % tiles_per_side);
+        };
+        if(thread_pool) {
+            thread_pool->run_and_wait(tiles_per_side * tiles_per_side, tile_task);
+        }
+        else {
+            for(unsigned tile_index = 0; tile_index < tiles_per_side * tiles_per_side; ++tile_index) {
+                tile_task(tile_index);
+            }
+        }
+        std::swap(matrix, squared_matrix);
+    }
+
+    // Computes one output tile of lhs * rhs into squared_matrix, walking over the matching tiles of both inputs.
+    void multiply_tile(const std::vector<Count>& lhs, const std::vector<Count>& rhs, unsigned tile_row, unsigned tile_column) {
+        const unsigned first_row = tile_row * TILE_SIZE;
+        const unsigned last_row = std::min(first_row + TILE_SIZE, number_of_pairs);
+        const unsigned first_column = tile_column * TILE_SIZE;
+        const unsigned last_column = std::min(first_column + TILE_SIZE, number_of_pairs);
+        std::array<std::array<DoubleCount, TILE_SIZE>, TILE_SIZE> sums{};
+        for(unsigned first_inner = 0; first_inner < number_of_pairs; first_inner += TILE_SIZE) {
+            const unsigned last_inner = std::min(first_inner + TILE_SIZE, number_of_pairs);
+            for(unsigned row = first_row; row < last_row; ++row) {
+                const Count* lhs_row = lhs.data() + static_cast<std::size_t>(row) * number_of_pairs;
+                auto& sums_row = sums[row - first_row];
+                for(unsigned inner = first_inner; inner < last_inner; ++inner) {
+                    const Count lhs_entry = lhs_row[inner];
+                    if(lhs_entry == 0) {
+                        continue;
+                    }
+                    const Count* rhs_row = rhs.data() + static_cast<std::size_t>(inner) * number_of_pairs;
+                    for(unsigned column = first_column; column < last_column; ++column) {
+                        DoubleCount& sum = sums_row[column - first_column];
+                        sum = checked_arithmetic::multiply_add(sum, lhs_entry, rhs_row[column]);
+                    }
+                }
+                for(unsigned column = first_column; column < last_column; ++column) {
+                    sums_row[column - first_column] = checked_arithmetic::remainder(sums_row[column - first_column], modulus);
+                }
+            }
+        }
+        for(unsigned row = first_row; row < last_row; ++row) {
+            for(unsigned column = first_column; column < last_column; ++column) {
+                squared_matrix[static_cast<std::size_t>(row) * number_of_pairs + column] = sums[row - first_row][column - first_column].low;
+            }
+        }
+    }
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <map>
+#include <limits>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <CheckedArithmetic.h>
+
+// Counts the pairs of adjacent elements of a polymer while pair insertion rules are applied.
+// Elements are numbered densely in the order of their first appearance, a pair is indexed by both element numbers.
+// Every pair turns into at most two pairs, so a step is a single pass over a flat array of counts into a second
+// array, after which the two arrays are swapped. A pair without a rule moves to itself and to a sink slot,
+// which is cleared before every step, so every pair is handled the same way and the pass allocates nothing.
+class PolymerPairEngine {
+public:
+    using Count = unsigned long long;
+
+    PolymerPairEngine(const std::string& polymer_template, const std::map<std::string, std::string>& insertion_rules) :
+        polymer_template{polymer_template} {
+        if(polymer_template.empty()) {
+            throw std::runtime_error{"Polymer template is empty"};
+        }
+        for(const char element: polymer_template) {
+            register_element(element);
+        }
+        for(const auto& [pair, inserted_element]: insertion_rules) {
+            if(pair.size() != 2 || inserted_element.size() != 1) {
+                throw std::runtime_error{"Invalid pair insertion rule " + pair + " -> " + inserted_element};
+            }
+            register_element(pair.at(0));
+            register_element(pair.at(1));
+            register_element(inserted_element.at(0));
+        }
+        const unsigned number_of_pairs = get_number_of_pairs();
+        sink_pair = number_of_pairs;
+        transitions.resize(number_of_pairs);
+        for(unsigned pair = 0; pair < number_of_pairs; ++pair) {
+            transitions[pair] = {pair, sink_pair};
+        }
+        for(const auto& [pair, inserted_element]: insertion_rules) {
+            const unsigned left = element_index(pair.at(0));
+            const unsigned right = element_index(pair.at(1));
+            const unsigned inserted = element_index(inserted_element.at(0));
+            transitions[pair_index(left, right)] = {pair_index(left, inserted), pair_index(inserted, right)};
+        }
+        pair_counts.resize(number_of_pairs + 1);
+        next_pair_counts.resize(number_of_pairs + 1);
+        reset();
+    }
+
+    // Goes back to the pairs of the polymer template.
+    void reset() {
+        std::fill(std::begin(pair_counts), std::end(pair_counts), 0);
+        for(std::size_t position = 0; position + 1 < polymer_template.size(); ++position) {
+            ++pair_counts[pair_index(element_index(polymer_template[position]), element_index(polymer_template[position + 1]))];
+        }
+    }
+
+    void apply_steps(unsigned number_of_steps) {
+        for(unsigned step = 0; step < number_of_steps; ++step) {
+            apply_step();
+        }
+    }
+
+    // Every element apart from the last one of the polymer starts exactly one pair, and the last one never changes.
+    [[nodiscard]]
+    std::vector<Count> count_elements() const {
+        std::vector<Count> element_counts(elements.size(), 0);
+        for(unsigned pair = 0; pair < sink_pair; ++pair) {
+            element_counts[pair / elements.size()] += pair_counts[pair];
+        }
+        ++element_counts[get_last_element()];
+        return element_counts;
+    }
+
+    // Elements which do not occur in the polymer are not taken into account.
+    // Shared with other element counters, such as the fast forward, whose counts may have another type.
+    template<typename ElementCount>
+    [[nodiscard]]
+    static ElementCount most_and_least_common_elements_quantity_difference(const std::vector<ElementCount>& element_counts) {
+        ElementCount most_common = 0;
+        ElementCount least_common = std::numeric_limits<ElementCount>::max();
+        for(const ElementCount element_count: element_counts) {
+            if(element_count != 0) {
+                most_common = std::max(most_common, element_count);
+                least_common = std::min(least_common, element_count);
+            }
+        }
+        return most_common - least_common;
+    }
+
+    [[nodiscard]]
+    Count most_and_least_common_elements_quantity_difference() const {
+        return most_and_least_common_elements_quantity_difference(count_elements());
+    }
+
+    [[nodiscard]]
+    inline unsigned get_number_of_pairs() const {
+        return static_cast<unsigned>(elements.size() * elements.size());
+    }
+
+    [[nodiscard]]
+    inline const std::string& get_elements() const {
+        return elements;
+    }
+
+    [[nodiscard]]
+    inline const std::vector<std::pair<unsigned, unsigned>>& get_transitions() const {
+        return transitions;
+    }
+
+    [[nodiscard]]
+    inline const std::vector<Count>& get_pair_counts() const {
+        return pair_counts;
+    }
+
+    // The last element of the polymer is the only one which does not start a pair.
+    [[nodiscard]]
+    inline unsigned get_last_element() const {
+        return element_index(polymer_template.back());
+    }
+
+    [[nodiscard]]
+    inline unsigned pair_index(unsigned left_element, unsigned right_element) const {
+        return left_element * static_cast<unsigned>(elements.size()) + right_element;
+    }
+
+private:
+    static constexpr unsigned NOT_AN_ELEMENT = std::numeric_limits<unsigned>::max();
+
+    std::string polymer_template{};
+    std::string elements{};
+    std::vector<unsigned> element_indices = std::vector<unsigned>(std::numeric_limits<unsigned char>::max() + 1, NOT_AN_ELEMENT);
+    // Both pairs created from every pair, the sink pair collects the counts of pairs without a rule.
+    std::vector<std::pair<unsigned, unsigned>> transitions{};
+    unsigned sink_pair{};
+    std::vector<Count> pair_counts{};
+    std::vector<Count> next_pair_counts{};
+
+    [[nodiscard]]
+    inline unsigned element_index(char element) const {
+        const unsigned index = element_indices[static_cast<unsigned char>(element)];
+        if(index == NOT_AN_ELEMENT) {
+            throw std::runtime_error{std::string{"Unknown element "} + element};
+        }
+        return index;
+    }
+
+    void register_element(char element) {
+        unsigned& index = element_indices[static_cast<unsigned char>(element)];
+        if(index == NOT_AN_ELEMENT) {
+            index = static_cast<unsigned>(elements.size());
+            elements.push_back(element);
+        }
+    }
+
+    void apply_step() {
+        std::fill(std::begin(next_pair_counts), std::end(next_pair_counts), 0);
+        const std::size_t number_of_pairs = transitions.size();
+        for(std::size_t pair = 0; pair < number_of_pairs; ++pair) {
+            const Count count = pair_counts[pair];
+            const auto [left_pair, right_pair] = transitions[pair];
+            if(checked_arithmetic::add_overflows(next_pair_counts[left_pair], count, next_pair_counts[left_pair]) ||
+               checked_arithmetic::add_overflows(next_pair_counts[right_pair], count, next_pair_counts[right_pair])) {
+                throw std::overflow_error{"Number of pairs does not fit into 64 bits"};
+            }
+        }
+        std::swap(pair_counts, next_pair_counts);
+    }
+};
@@ -4,6 +4,10 @@
 #include <map>
 
 #include <Utils.h>
+#include <Benchmark.h>
+#include <CheckedArithmetic.h>
+#include <PolymerPairEngine.h>
+#include <PolymerFastForward.h>
 
 using PairHistogram = std::map<std::string, long long int>;
 using InsertionRules = std::map<std::string, std::string>;
@@ -91,9 +95,93 @@ long long int run_simulation(const std::string& polymer_template, const std::map
     return most_and_least_common_elements_quantity_difference(polymer_histogram, polymer_template);
 }
 
-int main() {
+PolymerPairEngine::Count solve(const std::string& polymer_template, const InsertionRules& pair_insertion_rules, unsigned number_of_steps) {
+    PolymerPairEngine engine{polymer_template, pair_insertion_rules};
+    engine.apply_steps(number_of_steps);
+    return engine.most_and_least_common_elements_quantity_difference();
+}
+
+void report_step_time(const std::string& polymer_template, const InsertionRules& pair_insertion_rules) {
+    constexpr unsigned NUMBER_OF_STEPS = 40;
+    constexpr unsigned NUMBER_OF_RUNS = 1'000;
+    long long map_result = 0;
+    double map_time = benchmark::measure_milliseconds([&]() {
+        for(unsigned run = 0; run < NUMBER_OF_RUNS; ++run) {
+            map_result = run_simulation(polymer_template, pair_insertion_rules, NUMBER_OF_STEPS);
+        }
+    });
+    PolymerPairEngine engine{polymer_template, pair_insertion_rules};
+    PolymerPairEngine::Count engine_result = 0;
+    double engine_time = benchmark::measure_milliseconds([&]() {
+        for(unsigned run = 0; run < NUMBER_OF_RUNS; ++run) {
+            engine.reset();
+            engine.apply_steps(NUMBER_OF_STEPS);
+            engine_result = engine.most_and_least_common_elements_quantity_difference();
+        }
+    });
+    const double nanoseconds_per_step_per_millisecond = 1e6 / (NUMBER_OF_RUNS * NUMBER_OF_STEPS);
+    std::cout << "Elements: " << engine.get_elements().size() << ", pairs: " << engine.get_number_of_pairs() << std::endl;
+    std::cout << "Map histogram: " << map_result << ", " << map_time * nanoseconds_per_step_per_millisecond << " ns per step" << std::endl;
+    std::cout << "Dense pair engine: " << engine_result << ", " << engine_time * nanoseconds_per_step_per_millisecond << " ns per step" << std::endl;
+}
+
+// Every pair of the input has a rule, so the polymer grows from n to 2n - 1 elements in every step.
+PolymerFastForward::Count expected_polymer_length(std::size_t template_length, unsigned long long number_of_steps, PolymerFastForward::Count modulus) {
+    using Count = PolymerFastForward::Count;
+    const auto multiply = [modulus](Count lhs, Count rhs) {
+        return checked_arithmetic::remainder(checked_arithmetic::multiply_wide(lhs, rhs), modulus);
+    };
+    Count power_of_two = 1;
+    for(Count base = 2 % modulus; number_of_steps != 0; number_of_steps >>= 1, base = multiply(base, base)) {
+        if(number_of_steps & 1) {
+            power_of_two = multiply(power_of_two, base);
+        }
+    }
+    return (multiply((template_length - 1) % modulus, power_of_two) + 1) % modulus;
+}
+
+void report_fast_forward(const std::string& polymer_template, const InsertionRules& pair_insertion_rules) {
+    constexpr unsigned NUMBER_OF_STEPS = 40;
+    const PolymerPairEngine engine{polymer_template, pair_insertion_rules};
+    PolymerPairEngine stepped_engine = engine;
+    stepped_engine.apply_steps(NUMBER_OF_STEPS);
+    const PolymerPairEngine::Count expected_difference = stepped_engine.most_and_least_common_elements_quantity_difference();
+    std::vector<unsigned> thread_counts{1};
+    if(std::thread::hardware_concurrency() > 1) {
+        thread_counts.push_back(std::thread::hardware_concurrency());
+    }
+    for(const unsigned number_of_threads: thread_counts) {
+        PolymerFastForward fast_forward{engine, PolymerFastForward::DEFAULT_MODULUS, number_of_threads};
+        std::vector<PolymerFastForward::Count> element_counts{};
+        double time = benchmark::measure_milliseconds([&]() { element_counts = fast_forward.count_elements_after(NUMBER_OF_STEPS); });
+        const auto difference = PolymerPairEngine::most_and_least_common_elements_quantity_difference(element_counts);
+        if(difference != expected_difference) {
+            throw std::runtime_error{"Fast forward result differs from the step by step one"};
+        }
+        std::cout << "Fast forward by " << NUMBER_OF_STEPS << " steps with " << fast_forward.get_number_of_threads() << " threads: "
+                  << difference << ", step by step: " << expected_difference << ", in " << time << " ms" << std::endl;
+    }
+    constexpr PolymerFastForward::Count MODULUS = 1'000'000'007;
+    PolymerFastForward fast_forward{engine, MODULUS};
+    for(const unsigned long long number_of_steps: {1'000'000ULL, 1'000'000'000'000ULL, 1'000'000'000'000'000'000ULL}) {
+        std::vector<PolymerFastForward::Count> element_counts{};
+        double time = benchmark::measure_milliseconds([&]() { element_counts = fast_forward.count_elements_after(number_of_steps); });
+        PolymerFastForward::Count polymer_length = 0;
+        for(const auto element_count: element_counts) {
+            polymer_length = (polymer_length + element_count) % MODULUS;
+        }
+        std::cout << "Fast forward by " << number_of_steps << " steps modulo " << MODULUS << ": polymer length " << polymer_length
+                  << ", expected " << expected_polymer_length(polymer_template.size(), number_of_steps, MODULUS) << ", time: " << time << " ms" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
     const auto[polymer_template, insertion_rules] = read_puzzle_input("input.txt");
-    std::cout << "Part 1: " << run_simulation(polymer_template, insertion_rules, 10) << std::endl;
-    std::cout << "Part 2: " << run_simulation(polymer_template, insertion_rules, 40) << std::endl;
+    std::cout << "Part 1: " << solve(polymer_template, insertion_rules, 10) << std::endl;
+    std::cout << "Part 2: " << solve(polymer_template, insertion_rules, 40) << std::endl;
+    if(benchmark::is_requested(argc, argv)) {
+        report_step_time(polymer_template, insertion_rules);
+        report_fast_forward(polymer_template, insertion_rules);
+    }
     return 0;
 }
\ No newline at end of file
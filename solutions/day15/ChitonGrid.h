@@ -0,0 +1,7 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+using ChitonGrid = std::vector<std::vector<unsigned>>;
+using Chiton = std::pair<unsigned, unsigned>;
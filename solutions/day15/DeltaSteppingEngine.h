@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#include <ThreadPool.h>
+#include <ChitonGrid.h>
+
+class DeltaSteppingEngine {
+public:
+
+    explicit DeltaSteppingEngine(const ChitonGrid& risks, unsigned number_of_threads = std::thread::hardware_concurrency(), unsigned delta = 0) :
+        grid_width{risks.empty() ? 0u : static_cast<unsigned>(risks.at(0).size())},
+        grid_height{static_cast<unsigned>(risks.size())},
+        number_of_threads{std::max(number_of_threads, 1u)},
+        thread_pool{number_of_threads > 1 ? std::make_unique<ThreadPool>(number_of_threads) : nullptr},
+        costs(grid_width * grid_height) {
+        if(grid_width == 0 || grid_height == 0) {
+            throw std::runtime_error{"Risk map can not be empty"};
+        }
+        risks_row_major.reserve(grid_width * grid_height);
+        for(const auto& row: risks) {
+            if(row.size() != grid_width) {
+                throw std::runtime_error{"Risk map has to be rectangular"};
+            }
+            risks_row_major.insert(std::end(risks_row_major), std::begin(row), std::end(row));
+        }
+        unsigned highest_risk = *std::max_element(std::begin(risks_row_major), std::end(risks_row_major));
+        bucket_width = delta == 0 ? std::max(highest_risk, 1u) : delta;
+        number_of_bucket_slots = highest_risk / bucket_width + 2;
+    }
+
+    [[nodiscard]]
+    unsigned find_shortest_path(const Chiton& source, const Chiton& destination) {
+        throw_if_out_of_bounds(source);
+        throw_if_out_of_bounds(destination);
+        initialize_search(to_index(source), to_index(destination));
+        // Every round relaxes parts of the frontier in parallel, then merges the buckets filled by all parts slot by slot.
+        while(!finished) {
+            run_in_parallel(number_of_threads, [this](unsigned part_index) { relax_frontier_part(part_index); });
+            run_in_parallel(number_of_bucket_slots, [this](unsigned slot) { merge_bucket_slot(slot); });
+            select_next_bucket();
+        }
+        return costs[destination_index].load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr unsigned UNREACHED = std::numeric_limits<unsigned>::max();
+
+    unsigned grid_width{};
+    unsigned grid_height{};
+    unsigned number_of_threads{};
+    unsigned bucket_width{};
+    unsigned number_of_bucket_slots{};
+    std::unique_ptr<ThreadPool> thread_pool{};
+    std::vector<unsigned> risks_row_major{};
+    std::vector<std::atomic<unsigned>> costs{};
+
+    std::vector<std::vector<unsigned>> buckets{};
+    std::vector<std::vector<std::vector<unsigned>>> buckets_filled_by_threads{};
+    std::vector<unsigned> frontier{};
+    unsigned current_bucket{};
+    unsigned destination_index{};
+    bool finished{};
+
+    void throw_if_out_of_bounds(const Chiton& coordinates) const {
+        if(coordinates.first >= grid_width || coordinates.second >= grid_height) {
+            throw std::runtime_error{"Coordinates are outside of the risk map"};
+        }
+    }
+
+    [[nodiscard]]
+    inline unsigned to_index(const Chiton& coordinates) const {
+        return coordinates.second * grid_width + coordinates.first;
+    }
+
+    void initialize_search(unsigned source_index, unsigned destination) {
+        for(auto& cost: costs) {
+            cost.store(UNREACHED, std::memory_order_relaxed);
+        }
+        costs[source_index].store(0, std::memory_order_relaxed);
+        buckets.assign(number_of_bucket_slots, {});
+        buckets_filled_by_threads.assign(number_of_threads, std::vector<std::vector<unsigned>>(number_of_bucket_slots));
+        frontier.assign(1, source_index);
+        current_bucket = 0;
+        destination_index = destination;
+        finished = false;
+    }
+
+    template<typename Task>
+    void run_in_parallel(unsigned number_of_tasks, const Task& task) {
+        if(thread_pool) {
+            thread_pool->run_and_wait(number_of_tasks, task);
+        }
+        else {
+            for(unsigned task_index = 0; task_index < number_of_tasks; ++task_index) {
+                task(task_index);
+            }
+        }
+    }
+
+    void relax_frontier_part(unsigned part_index) {
+        auto& filled_buckets = buckets_filled_by_threads[part_index];
+        const std::size_t first = frontier.size() * part_index / number_of_threads;
+        const std::size_t last = frontier.size() * (part_index + 1) / number_of_threads;
+        for(std::size_t i = first; i < last; ++i) {
+            relax_neighbours(frontier[i], filled_buckets);
+        }
+    }
+
+    void relax_neighbours(unsigned index, std::vector<std::vector<unsigned>>& filled_buckets) {
+        const unsigned cost = costs[index].load(std::memory_order_relaxed);
+        if(cost / bucket_width != current_bucket) {
+            return;
+        }
+        const unsigned x = index % grid_width;
+        const unsigned y = index / grid_width;
+        if(x > 0) relax(cost, index - 1, filled_buckets);
+        if(x + 1 < grid_width) relax(cost, index + 1, filled_buckets);
+        if(y > 0) relax(cost, index - grid_width, filled_buckets);
+        if(y + 1 < grid_height) relax(cost, index + grid_width, filled_buckets);
+    }
+
+    inline void relax(unsigned cost, unsigned neighbour, std::vector<std::vector<unsigned>>& filled_buckets) {
+        const unsigned new_cost = cost + risks_row_major[neighbour];
+        unsigned old_cost = costs[neighbour].load(std::memory_order_relaxed);
+        while(new_cost < old_cost) {
+            if(costs[neighbour].compare_exchange_weak(old_cost, new_cost, std::memory_order_relaxed)) {
+                filled_buckets[(new_cost / bucket_width) % number_of_bucket_slots].push_back(neighbour);
+                return;
+            }
+        }
+    }
+
+    // Every slot is written by one task only, so slots are merged in parallel.
+    void merge_bucket_slot(unsigned slot) {
+        auto& bucket = buckets[slot];
+        for(auto& filled_buckets: buckets_filled_by_threads) {
+            bucket.insert(std::end(bucket), std::begin(filled_buckets[slot]), std::end(filled_buckets[slot]));
+            filled_buckets[slot].clear();
+        }
+    }
+
+    void select_next_bucket() {
+        unsigned skipped_buckets = 0;
+        while(buckets[current_bucket % number_of_bucket_slots].empty() && skipped_buckets < number_of_bucket_slots) {
+            ++current_bucket;
+            ++skipped_buckets;
+        }
+        const unsigned destination_cost = costs[destination_index].load(std::memory_order_relaxed);
+        const bool destination_settled = destination_cost != UNREACHED && destination_cost / bucket_width < current_bucket;
+        finished = skipped_buckets == number_of_bucket_slots || destination_settled;
+        frontier.clear();
+        std::swap(frontier, buckets[current_bucket % number_of_bucket_slots]);
+    }
+};
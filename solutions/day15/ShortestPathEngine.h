@@ -0,0 +1,115 @@
+#pragma once
+
+#include <map>
+#include <deque>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include <ChitonGrid.h>
+
+class ShortestPathEngine {
+public:
+
+    explicit ShortestPathEngine(const ChitonGrid& risks, unsigned max_cached_sources = 4) :
+        risks{risks},
+        max_cached_sources{max_cached_sources} {
+        if(risks.empty() || risks.at(0).empty()) {
+            throw std::runtime_error{"Risk map can not be empty"};
+        }
+        if(max_cached_sources == 0) {
+            throw std::runtime_error{"At least one distance field has to be cached"};
+        }
+    }
+
+    [[nodiscard]]
+    unsigned find_shortest_path(const Chiton& source, const Chiton& destination) {
+        // The destination is checked first, an invalid one must not cost a search or evict a cached field.
+        throw_if_out_of_bounds(destination);
+        const auto& distance_field = get_distance_field(source);
+        return distance_field[destination.second][destination.first];
+    }
+
+    // Cached fields are reused for later sources, the returned reference may point to the distances of another source
+    // after any later call for a source which is not cached, so it should not be kept across such calls.
+    const ChitonGrid& get_distance_field(const Chiton& source) {
+        throw_if_out_of_bounds(source);
+        if(const auto cached = distance_fields_by_source.find(source); cached != std::end(distance_fields_by_source)) {
+            return cached->second;
+        }
+        auto& costs_array = acquire_costs_array(source);
+        compute_distance_field(source, costs_array);
+        return costs_array;
+    }
+
+    [[nodiscard]]
+    inline unsigned number_of_cached_sources() const {
+        return distance_fields_by_source.size();
+    }
+
+private:
+    using QueueEntry = std::pair<unsigned, Chiton>;
+
+    const ChitonGrid& risks;
+    unsigned max_cached_sources{};
+    std::map<Chiton, ChitonGrid> distance_fields_by_source{};
+    std::deque<Chiton> sources_in_computation_order{};
+    std::vector<QueueEntry> queue{};
+
+    void throw_if_out_of_bounds(const Chiton& coordinates) const {
+        if(coordinates.second >= risks.size() || coordinates.first >= risks.at(coordinates.second).size()) {
+            throw std::runtime_error{"Coordinates are outside of the risk map"};
+        }
+    }
+
+    ChitonGrid& acquire_costs_array(const Chiton& source) {
+        sources_in_computation_order.push_back(source);
+        if(distance_fields_by_source.size() < max_cached_sources) {
+            ChitonGrid costs_array(risks.size(), std::vector<unsigned>(risks.at(0).size()));
+            return distance_fields_by_source.emplace(source, std::move(costs_array)).first->second;
+        }
+        auto evicted = distance_fields_by_source.extract(sources_in_computation_order.front());
+        sources_in_computation_order.pop_front();
+        evicted.key() = source;
+        return distance_fields_by_source.insert(std::move(evicted)).position->second;
+    }
+
+    void compute_distance_field(const Chiton& source, ChitonGrid& costs_array) {
+        for(auto& row: costs_array) {
+            std::fill(std::begin(row), std::end(row), std::numeric_limits<unsigned>::max());
+        }
+        costs_array[source.second][source.first] = 0;
+        queue.clear();
+        push(0, source);
+
+        const unsigned width = risks.at(0).size();
+        const unsigned height = risks.size();
+        while(!queue.empty()) {
+            std::pop_heap(std::begin(queue), std::end(queue), std::greater<>{});
+            const auto[cost, next] = queue.back();
+            queue.pop_back();
+            if(cost > costs_array[next.second][next.first]) {
+                continue;
+            }
+            const auto[x, y] = next;
+            if(x > 0) relax(cost, {x - 1, y}, costs_array);
+            if(x + 1 < width) relax(cost, {x + 1, y}, costs_array);
+            if(y > 0) relax(cost, {x, y - 1}, costs_array);
+            if(y + 1 < height) relax(cost, {x, y + 1}, costs_array);
+        }
+    }
+
+    inline void relax(unsigned cost, const Chiton& neighbour, ChitonGrid& costs_array) {
+        unsigned new_cost = cost + risks[neighbour.second][neighbour.first];
+        if(new_cost < costs_array[neighbour.second][neighbour.first]) {
+            costs_array[neighbour.second][neighbour.first] = new_cost;
+            push(new_cost, neighbour);
+        }
+    }
+
+    inline void push(unsigned cost, const Chiton& coordinates) {
+        queue.emplace_back(cost, coordinates);
+        std::push_heap(std::begin(queue), std::end(queue), std::greater<>{});
+    }
+};
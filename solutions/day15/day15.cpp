@@ -5,9 +5,10 @@
 #include <queue>
 
 #include <Utils.h>
-
-using ChitonGrid = std::vector<std::vector<unsigned>>;
-using Chiton = std::pair<unsigned, unsigned>;
+#include <Benchmark.h>
+#include <ChitonGrid.h>
+#include <ShortestPathEngine.h>
+#include <DeltaSteppingEngine.h>
 
 ChitonGrid read_puzzle_input(const std::string& file_name) {
     std::ifstream file{file_name};
@@ -78,7 +79,8 @@ unsigned find_shortest_path_from_source_to_destination(const Chiton& source, con
 unsigned solve_part_one(const ChitonGrid& risks) {
     Chiton source{0, 0};
     Chiton destination{risks.at(risks.size() - 1).size() - 1, risks.size() - 1};
-    return find_shortest_path_from_source_to_destination(source, destination, risks);
+    ShortestPathEngine engine{risks};
+    return engine.find_shortest_path(source, destination);
 }
 
 ChitonGrid expand_grid(const ChitonGrid& initial_grid) {
@@ -101,12 +103,57 @@ unsigned solve_part_two(const ChitonGrid& risks) {
     const auto expanded_risks = expand_grid(risks);
     Chiton source{0, 0};
     Chiton destination{expanded_risks.at(expanded_risks.size() - 1).size() - 1, expanded_risks.size() - 1};
-    return find_shortest_path_from_source_to_destination(source, destination, expanded_risks);
+    ShortestPathEngine engine{expanded_risks};
+    return engine.find_shortest_path(source, destination);
 }
 
-int main() {
+// Mixes repeated and new sources, so cached fields are both reused and evicted.
+void report_multi_query_engine(const ChitonGrid& risks) {
+    const unsigned width = risks.at(0).size();
+    const unsigned height = risks.size();
+    const std::vector<Chiton> sources{{0, 0}, {width - 1, 0}, {0, 0}, {width / 2, height / 2}, {0, height - 1}, {width - 1, 0}, {0, 0}};
+    const std::vector<Chiton> destinations{{width - 1, height - 1}, {0, height - 1}, {width / 3, height / 4}};
+    ShortestPathEngine engine{risks, 2};
+    unsigned number_of_queries = 0;
+    double time = benchmark::measure_milliseconds([&]() {
+        for(const auto& source: sources) {
+            for(const auto& destination: destinations) {
+                if(engine.find_shortest_path(source, destination) != find_shortest_path_from_source_to_destination(source, destination, risks)) {
+                    throw std::runtime_error{"Cached shortest path differs from the sequential one"};
+                }
+                ++number_of_queries;
+            }
+        }
+    });
+    std::cout << "Multi-query engine: " << number_of_queries << " queries from " << sources.size() << " sources checked in " << time
+              << " ms, cached sources: " << engine.number_of_cached_sources() << std::endl;
+}
+
+void report_delta_stepping_speedup(const ChitonGrid& risks) {
+    const auto expanded_risks = expand_grid(expand_grid(risks));
+    Chiton source{0, 0};
+    Chiton destination{expanded_risks.at(expanded_risks.size() - 1).size() - 1, expanded_risks.size() - 1};
+    const unsigned expected_cost = find_shortest_path_from_source_to_destination(source, destination, expanded_risks);
+    double single_thread_time = 0.0;
+    for(unsigned number_of_threads = 1; number_of_threads <= std::thread::hardware_concurrency(); number_of_threads *= 2) {
+        DeltaSteppingEngine engine{expanded_risks, number_of_threads};
+        unsigned cost = 0;
+        double time = benchmark::measure_milliseconds([&]() { cost = engine.find_shortest_path(source, destination); });
+        if(cost != expected_cost) {
+            throw std::runtime_error{"Delta-stepping result differs from the sequential one"};
+        }
+        single_thread_time = number_of_threads == 1 ? time : single_thread_time;
+        std::cout << "Threads: " << number_of_threads << ", time: " << time << " ms, speedup: " << single_thread_time / time << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
     const auto puzzle_input = read_puzzle_input("input.txt");
     std::cout << "Part 1: " << solve_part_one(puzzle_input) << std::endl;
     std::cout << "Part 2: " << solve_part_two(puzzle_input) << std::endl;
+    if(benchmark::is_requested(argc, argv)) {
+        report_multi_query_engine(puzzle_input);
+        report_delta_stepping_speedup(puzzle_input);
+    }
     return 0;
 }
\ No newline at end of file
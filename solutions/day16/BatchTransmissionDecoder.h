@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+#include <string_view>
+
+#include <ThreadPool.h>
+#include <BitReader.h>
+#include <Converters.h>
+#include <PacketTree.h>
+#include <PacketsParser.h>
+
+// Decodes a buffer of newline separated hex transmissions, empty lines are skipped.
+// Lines are split into consecutive ranges handled on a thread pool, every range unpacks its transmissions
+// into a byte buffer and decodes them into a packet tree it owns, both are reused by later batches.
+class BatchTransmissionDecoder {
+public:
+
+    struct Result {
+        unsigned version_sum = 0;
+        long long value = 0;
+    };
+
+    explicit BatchTransmissionDecoder(unsigned number_of_threads = std::thread::hardware_concurrency()) :
+        thread_pool{number_of_threads > 1 ? std::make_unique<ThreadPool>(number_of_threads) : nullptr},
+        workspaces(std::max(number_of_threads, 1u) * RANGES_PER_THREAD) {}
+
+    const std::vector<Result>& decode(std::string_view transmissions) {
+        split_into_lines(transmissions);
+        results.resize(lines.size());
+        const unsigned number_of_ranges = std::min<std::size_t>(workspaces.size(), lines.size());
+        const auto range_task = [this, number_of_ranges](unsigned range_index) {
+            const std::size_t first_line = range_index * lines.size() / number_of_ranges;
+            const std::size_t last_line = (range_index + 1) * lines.size() / number_of_ranges;
+            decode_lines(workspaces[range_index], first_line, last_line);
+        };
+        if(thread_pool) {
+            thread_pool->run_and_wait(number_of_ranges, range_task);
+        }
+        else {
+            for(unsigned range_index = 0; range_index < number_of_ranges; ++range_index) {
+                range_task(range_index);
+            }
+        }
+        return results;
+    }
+
+private:
+    static constexpr unsigned RANGES_PER_THREAD = 4;
+    static constexpr unsigned BITS_PER_HEX_DIGIT = 4;
+
+    struct Workspace {
+        std::vector<std::uint8_t> bytes{};
+        PacketTree packet_tree{};
+    };
+
+    std::unique_ptr<ThreadPool> thread_pool{};
+    std::vector<Workspace> workspaces{};
+    std::vector<std::string_view> lines{};
+    std::vector<Result> results{};
+
+    void split_into_lines(std::string_view transmissions) {
+        lines.clear();
+        while(!transmissions.empty()) {
+            const std::size_t line_end = std::min(transmissions.find('\n'), transmissions.size());
+            std::string_view line = transmissions.substr(0, line_end);
+            while(!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+                line.remove_suffix(1);
+            }
+            if(!line.empty()) {
+                lines.emplace_back(line);
+            }
+            transmissions.remove_prefix(std::min(line_end + 1, transmissions.size()));
+        }
+    }
+
+    void decode_lines(Workspace& workspace, std::size_t first_line, std::size_t last_line) {
+        for(std::size_t line = first_line; line < last_line; ++line) {
+            converters::hex_digits_to_bytes(lines[line], workspace.bytes);
+            BitReader reader{workspace.bytes, lines[line].size() * BITS_PER_HEX_DIGIT};
+            PacketsParser::parse_into(reader, workspace.packet_tree);
+            results[line] = {workspace.packet_tree.get_version_sum(), workspace.packet_tree.get_value()};
+        }
+    }
+};
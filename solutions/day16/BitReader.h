@@ -0,0 +1,128 @@
+#pragma once
+
+#include <string_view>
+#include <istream>
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+
+#include <Converters.h>
+
+// Reads fields of up to 32 bits straight from hexadecimal digits, most significant bit first.
+// Hex digits are shifted into a 64-bit buffer only when a field needs them, nothing is allocated.
+// Digits come either from a string or from a stream, which is read in chunks up to the first whitespace.
+// Digits already unpacked into bytes are shifted in a byte at a time. Only readers of a stream own a chunk buffer,
+// so readers of strings and bytes stay small enough to be created for every transmission of a batch.
+class BitReader {
+public:
+    static constexpr unsigned MAXIMAL_FIELD_LENGTH = 32;
+
+    explicit BitReader(std::string_view hex_digits) :
+        hex_digits{hex_digits} {}
+
+    explicit BitReader(std::istream& hex_stream) :
+        stream_source{std::make_unique<StreamSource>(hex_stream)} {}
+
+    BitReader(const std::vector<std::uint8_t>& bytes, std::uint64_t number_of_bits) :
+        bytes{bytes.data()},
+        number_of_bytes{bytes.size()},
+        bit_limit{number_of_bits} {}
+
+    BitReader(const BitReader&) = delete;
+    BitReader& operator=(const BitReader&) = delete;
+
+    [[nodiscard]]
+    unsigned read(unsigned length) {
+        if(length > MAXIMAL_FIELD_LENGTH) {
+            throw std::runtime_error{"Bit field is too long"};
+        }
+        if(consumed_bits + length > bit_limit) {
+            throw std::runtime_error{"Transmission ended in the middle of a packet"};
+        }
+        while(bits_in_buffer < length) {
+            refill_buffer();
+        }
+        bits_in_buffer -= length;
+        consumed_bits += length;
+        return static_cast<unsigned>((buffer >> bits_in_buffer) & ((Buffer{1} << length) - 1));
+    }
+
+    [[nodiscard]]
+    inline bool read_bit() {
+        return read(1) == 1;
+    }
+
+    // Number of bits read so far.
+    [[nodiscard]]
+    inline std::uint64_t position() const {
+        return consumed_bits;
+    }
+
+private:
+    using Buffer = std::uint64_t;
+    static constexpr unsigned BITS_PER_HEX_DIGIT = 4;
+    static constexpr unsigned BITS_PER_BYTE = 8;
+    static constexpr unsigned BUFFER_SIZE = 64;
+    static constexpr unsigned CHUNK_SIZE = 4096;
+
+    // Stream being read and the chunk its current digits are viewed in, reading stops at the first whitespace.
+    struct StreamSource {
+        explicit StreamSource(std::istream& hex_stream) : hex_stream{hex_stream} {}
+
+        std::istream& hex_stream;
+        bool reached_end = false;
+        std::array<char, CHUNK_SIZE> chunk{};
+    };
+
+    const std::uint8_t* bytes = nullptr;
+    std::size_t number_of_bytes = 0;
+    std::size_t next_byte = 0;
+    std::uint64_t bit_limit = std::numeric_limits<std::uint64_t>::max();
+    std::unique_ptr<StreamSource> stream_source{};
+    std::string_view hex_digits{};
+    std::size_t next_hex_digit = 0;
+    Buffer buffer = 0;
+    unsigned bits_in_buffer = 0;
+    std::uint64_t consumed_bits = 0;
+
+    void refill_buffer() {
+        if(bytes != nullptr) {
+            if(next_byte == number_of_bytes) {
+                throw std::runtime_error{"Transmission ended in the middle of a packet"};
+            }
+            for(; bits_in_buffer <= BUFFER_SIZE - BITS_PER_BYTE && next_byte < number_of_bytes; bits_in_buffer += BITS_PER_BYTE) {
+                buffer = (buffer << BITS_PER_BYTE) | bytes[next_byte++];
+            }
+            return;
+        }
+        if(next_hex_digit == hex_digits.size() && !read_next_chunk()) {
+            throw std::runtime_error{"Transmission ended in the middle of a packet"};
+        }
+        buffer = (buffer << BITS_PER_HEX_DIGIT) | converters::hex_digit_to_value(hex_digits[next_hex_digit++]);
+        bits_in_buffer += BITS_PER_HEX_DIGIT;
+    }
+
+    bool read_next_chunk() {
+        if(stream_source == nullptr || stream_source->reached_end || !stream_source->hex_stream) {
+            return false;
+        }
+        auto& chunk = stream_source->chunk;
+        stream_source->hex_stream.read(chunk.data(), chunk.size());
+        std::size_t chunk_length = stream_source->hex_stream.gcount();
+        const auto* whitespace = std::find_if(chunk.data(), chunk.data() + chunk_length, [](char character) {
+            return std::isspace(static_cast<unsigned char>(character));
+        });
+        if(whitespace != chunk.data() + chunk_length) {
+            chunk_length = whitespace - chunk.data();
+            stream_source->reached_end = true;
+        }
+        hex_digits = std::string_view{chunk.data(), chunk_length};
+        next_hex_digit = 0;
+        return chunk_length > 0;
+    }
+};
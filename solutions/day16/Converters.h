@@ -1,30 +1,70 @@
 #pragma once
 
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
 namespace converters {
 
-    std::string hex_to_binary(const char hex_digit, unsigned output_width = 4) {
-        unsigned value = hex_digit >= 'A' ? hex_digit - 'A' + 10 : hex_digit - '0';
-        std::string binary_string{};
-        for(unsigned i = 0; i < output_width; ++i) {
-            binary_string.insert(0, std::to_string((value >> i) & 1));
+    inline unsigned hex_digit_to_value(const char hex_digit) {
+        if(hex_digit >= '0' && hex_digit <= '9') {
+            return hex_digit - '0';
+        }
+        if(hex_digit >= 'A' && hex_digit <= 'F') {
+            return hex_digit - 'A' + 10;
         }
-        return binary_string;
+        if(hex_digit >= 'a' && hex_digit <= 'f') {
+            return hex_digit - 'a' + 10;
+        }
+        throw std::runtime_error{"Invalid hexadecimal digit"};
     }
 
-    std::string hex_to_binary(const std::string& hex_string) {
-        std::string binary_string{};
-        for(const auto& character: hex_string) {
-            binary_string += hex_to_binary(character);
-        }
-        return binary_string;
+    inline bool is_hex_digit(const char character) {
+        const unsigned char lower_case = static_cast<unsigned char>(character) | 0x20;
+        return static_cast<unsigned char>(character - '0') < 10 || static_cast<unsigned char>(lower_case - 'a') < 6;
     }
 
-    inline unsigned binary_to_decimal(const std::string& binary) {
-        return std::stoul(binary, nullptr, 2);
+    // Packs eight hex digits, loaded little-endian into one word, into four bytes with the first byte lowest.
+    // Letters have bit 6 set and their low nibble is one to six, adding 9 turns it into the digit value.
+    inline std::uint32_t pack_eight_hex_digits(std::uint64_t digits) {
+        constexpr std::uint64_t LOW_NIBBLES = 0x0F0F0F0F0F0F0F0FULL;
+        constexpr std::uint64_t LETTER_BITS = 0x4040404040404040ULL;
+        const std::uint64_t nibbles = (digits & LOW_NIBBLES) + ((digits & LETTER_BITS) >> 6) * 9;
+        const std::uint64_t byte_pairs = ((nibbles << 4) | (nibbles >> 8)) & 0x00FF00FF00FF00FFULL;
+        const std::uint64_t byte_quads = (byte_pairs | (byte_pairs >> 8)) & 0x0000FFFF0000FFFFULL;
+        return static_cast<std::uint32_t>(byte_quads | (byte_quads >> 16));
     }
 
-    inline long long binary_to_long_decimal(const std::string& binary) {
-        return static_cast<long long>(std::stoull(binary, nullptr, 2));
+    // Unpacks hex digits into bytes eight digits at a time, an odd last digit ends up in the high nibble.
+    // Words are loaded little-endian, which holds on every platform the solutions are built for.
+    inline void hex_digits_to_bytes(std::string_view hex_digits, std::vector<std::uint8_t>& bytes) {
+        bool all_digits_valid = true;
+        for(const char character: hex_digits) {
+            all_digits_valid &= is_hex_digit(character);
+        }
+        if(!all_digits_valid) {
+            throw std::runtime_error{"Invalid hexadecimal digit"};
+        }
+        bytes.resize((hex_digits.size() + 1) / 2);
+        std::size_t digit = 0;
+        for(; digit + 8 <= hex_digits.size(); digit += 8) {
+            std::uint64_t digits = 0;
+            std::memcpy(&digits, hex_digits.data() + digit, sizeof(digits));
+            const std::uint32_t packed = pack_eight_hex_digits(digits);
+            const std::array<std::uint8_t, 4> packed_bytes{
+                static_cast<std::uint8_t>(packed), static_cast<std::uint8_t>(packed >> 8),
+                static_cast<std::uint8_t>(packed >> 16), static_cast<std::uint8_t>(packed >> 24)
+            };
+            std::copy(std::begin(packed_bytes), std::end(packed_bytes), std::begin(bytes) + digit / 2);
+        }
+        for(; digit < hex_digits.size(); ++digit) {
+            const unsigned value = hex_digit_to_value(hex_digits[digit]);
+            bytes[digit / 2] = digit % 2 == 0 ? static_cast<std::uint8_t>(value << 4) : static_cast<std::uint8_t>(bytes[digit / 2] | value);
+        }
     }
 
 }
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include <PacketValue.h>
+
+// Packet without children or virtual functions, children of a packet are the packets in [index + 1, subtree_end).
+struct PacketNode {
+    std::uint32_t subtree_end = 0;
+    std::uint8_t version = 0;
+    std::uint8_t type_id = 0;
+    long long value = 0;
+};
+
+// All packets of a transmission in pre-order in a single array, which is reused when the tree is cleared.
+// Walking the array backwards visits every child before its parent, so evaluation needs neither recursion nor a stack.
+class PacketTree {
+public:
+    using Value = long long;
+    static constexpr std::uint8_t VALUE_PACKET_TYPE_ID = 4;
+
+    void clear() {
+        nodes.clear();
+        open_packets.clear();
+    }
+
+    void add_value_packet(unsigned version, long long value) {
+        const auto index = static_cast<std::uint32_t>(nodes.size());
+        nodes.emplace_back(PacketNode{index + 1, static_cast<std::uint8_t>(version), VALUE_PACKET_TYPE_ID, value});
+    }
+
+    // Sub-packets added until the matching close_operator_packet become children of the opened packet.
+    void open_operator_packet(unsigned version, unsigned type_id) {
+        const auto index = static_cast<std::uint32_t>(nodes.size());
+        nodes.emplace_back(PacketNode{index + 1, static_cast<std::uint8_t>(version), static_cast<std::uint8_t>(type_id), 0});
+        open_packets.emplace_back(index);
+    }
+
+    void close_operator_packet() {
+        if(open_packets.empty()) {
+            throw std::runtime_error{"There is no open operator packet to close"};
+        }
+        nodes[open_packets.back()].subtree_end = static_cast<std::uint32_t>(nodes.size());
+        open_packets.pop_back();
+    }
+
+    [[nodiscard]]
+    inline unsigned size() const {
+        return nodes.size();
+    }
+
+    [[nodiscard]]
+    unsigned get_version_sum() const {
+        unsigned version_sum = 0;
+        for(const auto& node: nodes) {
+            version_sum += node.version;
+        }
+        return version_sum;
+    }
+
+    [[nodiscard]]
+    long long get_value() {
+        if(nodes.empty()) {
+            throw std::runtime_error{"Packet tree is empty"};
+        }
+        values.resize(nodes.size());
+        for(unsigned index = nodes.size(); index-- > 0; ) {
+            values[index] = evaluate(index);
+        }
+        return values.front();
+    }
+
+private:
+    std::vector<PacketNode> nodes{};
+    std::vector<long long> values{};
+    std::vector<std::uint32_t> open_packets{};
+
+    // Values of all children are already known when a packet is evaluated.
+    [[nodiscard]]
+    long long evaluate(unsigned index) const {
+        const auto& node = nodes[index];
+        const unsigned first_child = index + 1;
+        const auto fold_children = [this, first_child, &node](long long initial_value, auto operation) {
+            long long result = initial_value;
+            for(unsigned child = first_child; child < node.subtree_end; child = nodes[child].subtree_end) {
+                result = operation(result, values[child]);
+            }
+            return result;
+        };
+        const auto first_child_value = [this, first_child, &node]() {
+            if(first_child >= node.subtree_end) {
+                throw std::runtime_error{"Operator packet needs at least one sub-packet"};
+            }
+            return values[first_child];
+        };
+        const auto compare_children = [this, first_child, &node](auto comparison) {
+            if(first_child >= node.subtree_end || nodes[first_child].subtree_end >= node.subtree_end) {
+                throw std::runtime_error{"Comparison packet needs two sub-packets"};
+            }
+            return comparison(values[first_child], values[nodes[first_child].subtree_end]) ? 1LL : 0LL;
+        };
+        switch(node.type_id) {
+            case 0: return fold_children(0LL, [](long long lhs, long long rhs) { return packet_value::add(lhs, rhs); });
+            case 1: return fold_children(1LL, [](long long lhs, long long rhs) { return packet_value::multiply(lhs, rhs); });
+            case 2: return fold_children(first_child_value(), [](long long lhs, long long rhs) { return std::min(lhs, rhs); });
+            case 3: return fold_children(first_child_value(), [](long long lhs, long long rhs) { return std::max(lhs, rhs); });
+            case VALUE_PACKET_TYPE_ID: return node.value;
+            case 5: return compare_children(std::greater<>{});
+            case 6: return compare_children(std::less<>{});
+            case 7: return compare_children(std::equal_to<>{});
+            default: throw std::runtime_error{"Unsupported type of operator packet"};
+        }
+    }
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdexcept>
+
+#include <WideInteger.h>
+#include <CheckedArithmetic.h>
+
+// Arithmetic on packet values, every operation throws instead of silently overflowing.
+namespace packet_value {
+
+    // Value of packets which are only counted, literals of any length are skipped.
+    struct SkippedValue {};
+
+    inline void append_value_group(SkippedValue&, unsigned, unsigned) {}
+
+    inline void append_value_group(long long& value, unsigned group, unsigned group_length) {
+        if(value >> (63 - group_length) != 0) {
+            throw std::overflow_error{"Value packet does not fit into 64 bits"};
+        }
+        value = (value << group_length) | group;
+    }
+
+    inline void append_value_group(WideInteger& value, unsigned group, unsigned group_length) {
+        value.append_bits(group, group_length);
+    }
+
+    inline long long add(long long lhs, long long rhs) {
+        long long sum = 0;
+        if(checked_arithmetic::add_overflows(lhs, rhs, sum)) {
+            throw std::overflow_error{"Sum packet does not fit into 64 bits"};
+        }
+        return sum;
+    }
+
+    inline WideInteger add(const WideInteger& lhs, const WideInteger& rhs) {
+        return lhs + rhs;
+    }
+
+    inline long long multiply(long long lhs, long long rhs) {
+        long long product = 0;
+        if(checked_arithmetic::multiply_overflows(lhs, rhs, product)) {
+            throw std::overflow_error{"Product packet does not fit into 64 bits"};
+        }
+        return product;
+    }
+
+    inline WideInteger multiply(const WideInteger& lhs, const WideInteger& rhs) {
+        return lhs * rhs;
+    }
+
+}
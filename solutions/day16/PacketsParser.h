@@ -1,17 +1,69 @@
 #pragma once
 
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <string_view>
+
 #include <Packets.h>
-#include <Converters.h>
+#include <PacketTree.h>
+#include <BitReader.h>
+#include <PacketValue.h>
 
 class PacketsParser {
 public:
 
-    static std::unique_ptr<Packet> parse(const std::string& binary_transmission) {
-        return extract_packet_data(binary_transmission).first;
+    static std::unique_ptr<Packet> parse(std::string_view hex_transmission) {
+        BitReader reader{hex_transmission};
+        return extract_packet(reader);
+    }
+
+    static void parse_into(std::string_view hex_transmission, PacketTree& tree) {
+        BitReader reader{hex_transmission};
+        parse_into(reader, tree);
+    }
+
+    static void parse_into(BitReader& reader, PacketTree& tree) {
+        tree.clear();
+        decode(reader, tree);
+    }
+
+    // Decodes one packet with all its sub-packets without recursion, pending operator packets are kept on an explicit stack.
+    // The visitor gets add_value_packet(version, value), open_operator_packet(version, type_id) and
+    // close_operator_packet() calls in pre-order, every open is matched by a close after the last sub-packet.
+    // Values are decoded into the visitor's Value type. The stack is kept per thread, so decoding many
+    // transmissions one after another does not allocate.
+    template<typename PacketVisitor>
+    static void decode(BitReader& reader, PacketVisitor& visitor) {
+        thread_local std::vector<PendingOperatorPacket> pending_operator_packets{};
+        pending_operator_packets.clear();
+        do {
+            const unsigned packet_version = reader.read(PACKET_VERSION_LENGTH);
+            const unsigned packet_type_id = reader.read(PACKET_TYPE_ID_LENGTH);
+            if(packet_type_id == VALUE_PACKET_TYPE_ID) {
+                visitor.add_value_packet(packet_version, extract_value_packet_content<typename PacketVisitor::Value>(reader));
+                count_finished_sub_packet(pending_operator_packets);
+            }
+            else {
+                visitor.open_operator_packet(packet_version, packet_type_id);
+                const bool counts_sub_packets = reader.read(PACKET_LENGTH_TYPE_ID_LENGTH) == 1;
+                const std::uint64_t limit = counts_sub_packets
+                    ? reader.read(NUMBER_OF_SUB_PACKETS_LENGTH)
+                    : reader.read(CONTENT_SIZE_IN_BITS_LENGTH) + reader.position();
+                pending_operator_packets.emplace_back(PendingOperatorPacket{counts_sub_packets, limit});
+            }
+            close_finished_operator_packets(pending_operator_packets, reader.position(), visitor);
+        } while(!pending_operator_packets.empty());
     }
 
 private:
-    using PacketData = std::pair<std::unique_ptr<Packet>, unsigned>;
+
+    // Operator packet whose sub-packets are still being parsed, the limit is either the number
+    // of remaining sub-packets or the position right after its last sub-packet.
+    struct PendingOperatorPacket {
+        bool counts_sub_packets = false;
+        std::uint64_t limit = 0;
+    };
 
     static constexpr unsigned PACKET_VERSION_LENGTH = 3;
     static constexpr unsigned PACKET_TYPE_ID_LENGTH = 3;
@@ -19,52 +71,48 @@ private:
     static constexpr unsigned CONTENT_SIZE_IN_BITS_LENGTH = 15;
     static constexpr unsigned NUMBER_OF_SUB_PACKETS_LENGTH = 11;
     static constexpr unsigned VALUE_PACKET_TYPE_ID = 4;
+    static constexpr unsigned VALUE_GROUP_LENGTH = 4;
 
-    static inline unsigned get_packet_version(const std::string& packet_as_binary) {
-        std::string version_as_binary = packet_as_binary.substr(0, PACKET_VERSION_LENGTH);
-        return converters::binary_to_decimal(version_as_binary);
-    }
-
-    static inline unsigned get_packet_type_id(const std::string& packet_as_binary) {
-        std::string type_id_as_binary = packet_as_binary.substr(PACKET_VERSION_LENGTH, PACKET_TYPE_ID_LENGTH);
-        return converters::binary_to_decimal(type_id_as_binary);
+    static void count_finished_sub_packet(std::vector<PendingOperatorPacket>& pending_operator_packets) {
+        if(!pending_operator_packets.empty() && pending_operator_packets.back().counts_sub_packets) {
+            --pending_operator_packets.back().limit;
+        }
     }
 
-    static inline std::string remove_packet_version_and_type(const std::string& packet_as_binary) {
-        return packet_as_binary.substr(PACKET_VERSION_LENGTH + PACKET_TYPE_ID_LENGTH);
+    template<typename PacketVisitor>
+    static void close_finished_operator_packets(std::vector<PendingOperatorPacket>& pending_operator_packets, std::uint64_t position, PacketVisitor& visitor) {
+        while(!pending_operator_packets.empty()) {
+            const auto& pending = pending_operator_packets.back();
+            const bool is_finished = pending.counts_sub_packets ? pending.limit == 0 : position >= pending.limit;
+            if(!is_finished) {
+                return;
+            }
+            visitor.close_operator_packet();
+            pending_operator_packets.pop_back();
+            count_finished_sub_packet(pending_operator_packets);
+        }
     }
 
-    static PacketData extract_packet_data(const std::string& binary_transmission) {
-        unsigned packet_version = get_packet_version(binary_transmission);
-        unsigned packet_type_id = get_packet_type_id(binary_transmission);
-        auto packet_content = remove_packet_version_and_type(binary_transmission);
+    static std::unique_ptr<Packet> extract_packet(BitReader& reader) {
+        unsigned packet_version = reader.read(PACKET_VERSION_LENGTH);
+        unsigned packet_type_id = reader.read(PACKET_TYPE_ID_LENGTH);
         return packet_type_id == VALUE_PACKET_TYPE_ID
-            ? extract_value_packet_data(packet_version, packet_content)
-            : extract_operator_packet_data(packet_version, packet_type_id, packet_content);
+            ? extract_value_packet(packet_version, reader)
+            : extract_operator_packet(packet_version, packet_type_id, reader);
     }
 
-    static std::string parse_value_packet_content(std::string packet_content) {
-        std::string value_as_binary{};
-        while(packet_content.length() >= 5) {
-            std::string next_five_bits = packet_content.substr(0, 5);
-            value_as_binary += next_five_bits.substr(1);
-            packet_content = packet_content.substr(5);
-            if(next_five_bits.at(0) == '0') {
-                break;
-            }
+    template<typename Value>
+    static Value extract_value_packet_content(BitReader& reader) {
+        Value value{};
+        for(bool has_more_groups = true; has_more_groups; ) {
+            has_more_groups = reader.read_bit();
+            packet_value::append_value_group(value, reader.read(VALUE_GROUP_LENGTH), VALUE_GROUP_LENGTH);
         }
-        return value_as_binary;
-    }
-
-    static unsigned compute_value_packet_length(const std::string& packet_value_as_binary) {
-        return PACKET_VERSION_LENGTH + PACKET_TYPE_ID_LENGTH + (packet_value_as_binary.length() / 4) * 5;
+        return value;
     }
 
-    static PacketData extract_value_packet_data(unsigned packet_version, const std::string& packet_content) {
-        std::string value_as_binary = parse_value_packet_content(packet_content);
-        long long packet_value = converters::binary_to_long_decimal(value_as_binary);
-        unsigned packet_length = compute_value_packet_length(value_as_binary);
-        return { std::make_unique<ValuePacket>(packet_version, packet_value), packet_length };
+    static std::unique_ptr<Packet> extract_value_packet(unsigned packet_version, BitReader& reader) {
+        return std::make_unique<ValuePacket>(packet_version, extract_value_packet_content<long long>(reader));
     }
 
     template<typename... Args>
@@ -81,36 +129,29 @@ private:
         }
     }
 
-    static PacketData extract_operator_packet_with_length_type_id_one_data(unsigned packet_version, unsigned packet_type_id, const std::string& packet_content) {
+    static std::unique_ptr<Packet> extract_operator_packet_with_length_type_id_one(unsigned packet_version, unsigned packet_type_id, BitReader& reader) {
         std::vector<std::unique_ptr<Packet>> sub_packets{};
-        unsigned number_of_sub_packets = converters::binary_to_decimal(packet_content.substr(0, NUMBER_OF_SUB_PACKETS_LENGTH));
-        unsigned total_packet_length = NUMBER_OF_SUB_PACKETS_LENGTH;
+        unsigned number_of_sub_packets = reader.read(NUMBER_OF_SUB_PACKETS_LENGTH);
         for(unsigned i = 0; i < number_of_sub_packets; ++i) {
-            auto[packet, packet_length] = extract_packet_data(packet_content.substr(total_packet_length));
-            sub_packets.emplace_back(std::move(packet));
-            total_packet_length += packet_length;
+            sub_packets.emplace_back(extract_packet(reader));
         }
-        total_packet_length += PACKET_VERSION_LENGTH + PACKET_TYPE_ID_LENGTH + PACKET_LENGTH_TYPE_ID_LENGTH;
-        return { operator_packet_by_type_id(packet_type_id, packet_version, std::move(sub_packets)), total_packet_length };
+        return operator_packet_by_type_id(packet_type_id, packet_version, std::move(sub_packets));
     }
 
-    static PacketData extract_operator_packet_with_length_type_id_zero_data(unsigned packet_version, unsigned packet_type_id, const std::string& packet_content) {
+    static std::unique_ptr<Packet> extract_operator_packet_with_length_type_id_zero(unsigned packet_version, unsigned packet_type_id, BitReader& reader) {
         std::vector<std::unique_ptr<Packet>> sub_packets{};
-        unsigned total_sub_packets_length = converters::binary_to_decimal(packet_content.substr(0, CONTENT_SIZE_IN_BITS_LENGTH));
-        std::string sub_packets_as_binary = packet_content.substr(CONTENT_SIZE_IN_BITS_LENGTH, total_sub_packets_length);
-        while(!sub_packets_as_binary.empty()) {
-            auto[packet, packet_length] = extract_packet_data(sub_packets_as_binary);
-            sub_packets.emplace_back(std::move(packet));
-            sub_packets_as_binary = sub_packets_as_binary.substr(packet_length);
+        unsigned total_sub_packets_length = reader.read(CONTENT_SIZE_IN_BITS_LENGTH);
+        const std::uint64_t sub_packets_end = reader.position() + total_sub_packets_length;
+        while(reader.position() < sub_packets_end) {
+            sub_packets.emplace_back(extract_packet(reader));
         }
-        unsigned total_packet_length = PACKET_VERSION_LENGTH + PACKET_TYPE_ID_LENGTH + PACKET_LENGTH_TYPE_ID_LENGTH + CONTENT_SIZE_IN_BITS_LENGTH + total_sub_packets_length;
-        return { operator_packet_by_type_id(packet_type_id, packet_version, std::move(sub_packets)), total_packet_length };
+        return operator_packet_by_type_id(packet_type_id, packet_version, std::move(sub_packets));
     }
 
-    static PacketData extract_operator_packet_data(unsigned packet_version, unsigned packet_type_id, const std::string& packet_content) {
-        return packet_content.at(0) == '1'
-            ? extract_operator_packet_with_length_type_id_one_data(packet_version, packet_type_id, packet_content.substr(PACKET_LENGTH_TYPE_ID_LENGTH))
-            : extract_operator_packet_with_length_type_id_zero_data(packet_version, packet_type_id, packet_content.substr(PACKET_LENGTH_TYPE_ID_LENGTH));
+    static std::unique_ptr<Packet> extract_operator_packet(unsigned packet_version, unsigned packet_type_id, BitReader& reader) {
+        return reader.read_bit()
+            ? extract_operator_packet_with_length_type_id_one(packet_version, packet_type_id, reader)
+            : extract_operator_packet_with_length_type_id_zero(packet_version, packet_type_id, reader);
     }
 
 };
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <vector>
+#include <istream>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+
+#include <BitReader.h>
+#include <PacketValue.h>
+#include <PacketsParser.h>
+#include <WideInteger.h>
+
+// Computes the version sum and the value while the packets are decoded, without building a tree.
+// Only operator packets which are still open keep an accumulator, so memory grows with the nesting depth only.
+// Values are either long long, which throws on overflow, or WideInteger for literals and results beyond 64 bits.
+template<typename ValueType>
+class BasicStreamingPacketEvaluator {
+public:
+    using Value = ValueType;
+
+    struct Result {
+        unsigned version_sum = 0;
+        Value value{};
+    };
+
+    Result evaluate(std::string_view hex_transmission) {
+        BitReader reader{hex_transmission};
+        return evaluate(reader);
+    }
+
+    Result evaluate(std::istream& hex_stream) {
+        BitReader reader{hex_stream};
+        return evaluate(reader);
+    }
+
+    void add_value_packet(unsigned version, const Value& value) {
+        version_sum += version;
+        finish_sub_packet(value);
+    }
+
+    void open_operator_packet(unsigned version, unsigned type_id) {
+        version_sum += version;
+        pending_operator_packets.emplace_back(PendingOperatorPacket{type_id});
+    }
+
+    void close_operator_packet() {
+        if(pending_operator_packets.empty()) {
+            throw std::runtime_error{"There is no open operator packet to close"};
+        }
+        const auto finished = pending_operator_packets.back();
+        pending_operator_packets.pop_back();
+        finish_sub_packet(value_of(finished));
+    }
+
+private:
+
+    struct PendingOperatorPacket {
+        unsigned type_id = 0;
+        unsigned number_of_sub_packets = 0;
+        Value accumulator{};
+    };
+
+    std::vector<PendingOperatorPacket> pending_operator_packets{};
+    unsigned version_sum = 0;
+    Value value{};
+
+    Result evaluate(BitReader& reader) {
+        pending_operator_packets.clear();
+        version_sum = 0;
+        value = Value{};
+        PacketsParser::decode(reader, *this);
+        return {version_sum, value};
+    }
+
+    void finish_sub_packet(const Value& sub_packet_value) {
+        if(pending_operator_packets.empty()) {
+            value = sub_packet_value;
+            return;
+        }
+        auto& parent = pending_operator_packets.back();
+        if(parent.number_of_sub_packets == 0) {
+            parent.accumulator = sub_packet_value;
+        }
+        else {
+            parent.accumulator = combine(parent, sub_packet_value);
+        }
+        ++parent.number_of_sub_packets;
+    }
+
+    static Value combine(const PendingOperatorPacket& parent, const Value& sub_packet_value) {
+        switch(parent.type_id) {
+            case 0: return packet_value::add(parent.accumulator, sub_packet_value);
+            case 1: return packet_value::multiply(parent.accumulator, sub_packet_value);
+            case 2: return std::min(parent.accumulator, sub_packet_value);
+            case 3: return std::max(parent.accumulator, sub_packet_value);
+            case 5: return compare(parent, sub_packet_value, std::greater<>{});
+            case 6: return compare(parent, sub_packet_value, std::less<>{});
+            case 7: return compare(parent, sub_packet_value, std::equal_to<>{});
+            default: throw std::runtime_error{"Unsupported type of operator packet"};
+        }
+    }
+
+    template<typename Comparison>
+    static Value compare(const PendingOperatorPacket& parent, const Value& sub_packet_value, Comparison comparison) {
+        if(parent.number_of_sub_packets != 1) {
+            throw std::runtime_error{"Comparison packet needs two sub-packets"};
+        }
+        return comparison(parent.accumulator, sub_packet_value) ? Value{1} : Value{0};
+    }
+
+    static Value value_of(const PendingOperatorPacket& finished) {
+        switch(finished.type_id) {
+            case 0: return finished.accumulator;
+            case 1: return finished.number_of_sub_packets == 0 ? Value{1} : finished.accumulator;
+            case 2:
+            case 3:
+                if(finished.number_of_sub_packets == 0) {
+                    throw std::runtime_error{"Operator packet needs at least one sub-packet"};
+                }
+                return finished.accumulator;
+            default:
+                if(finished.number_of_sub_packets != 2) {
+                    throw std::runtime_error{"Comparison packet needs two sub-packets"};
+                }
+                return finished.accumulator;
+        }
+    }
+};
+
+// Sums the versions of all packets while they are decoded. Values are never computed, so it accepts
+// transmissions whose values do not fit into any value type of the evaluator above.
+class StreamingVersionSummer {
+public:
+    using Value = packet_value::SkippedValue;
+
+    unsigned evaluate(std::string_view hex_transmission) {
+        BitReader reader{hex_transmission};
+        return evaluate(reader);
+    }
+
+    unsigned evaluate(std::istream& hex_stream) {
+        BitReader reader{hex_stream};
+        return evaluate(reader);
+    }
+
+    void add_value_packet(unsigned version, const Value&) {
+        version_sum += version;
+    }
+
+    void open_operator_packet(unsigned version, unsigned) {
+        version_sum += version;
+    }
+
+    void close_operator_packet() {}
+
+private:
+    unsigned version_sum = 0;
+
+    unsigned evaluate(BitReader& reader) {
+        version_sum = 0;
+        PacketsParser::decode(reader, *this);
+        return version_sum;
+    }
+};
+
+using StreamingPacketEvaluator = BasicStreamingPacketEvaluator<long long>;
+using WideStreamingPacketEvaluator = BasicStreamingPacketEvaluator<WideInteger>;
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <compare>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <CheckedArithmetic.h>
+
+// Unsigned integer of up to 256 bits kept in fixed 64-bit limbs, least significant limb first.
+// Values fitting into one limb take a fast path in every operation, nothing is ever allocated.
+class WideInteger {
+public:
+    using Limb = std::uint64_t;
+    static constexpr unsigned NUMBER_OF_LIMBS = 4;
+    static constexpr unsigned LIMB_SIZE = 64;
+
+    WideInteger() = default;
+
+    WideInteger(Limb value) {
+        limbs[0] = value;
+    }
+
+    [[nodiscard]]
+    inline bool fits_in_64_bits() const {
+        return used_limbs == 1;
+    }
+
+    [[nodiscard]]
+    inline Limb low_64_bits() const {
+        return limbs[0];
+    }
+
+    // Shifts the value left by length bits, which has to be between 1 and 63, and puts bits into the freed low bits.
+    void append_bits(Limb bits, unsigned length) {
+        if(fits_in_64_bits() && length < LIMB_SIZE && (limbs[0] >> (LIMB_SIZE - length)) == 0) {
+            limbs[0] = (limbs[0] << length) | bits;
+            return;
+        }
+        if(limbs[NUMBER_OF_LIMBS - 1] >> (LIMB_SIZE - length) != 0) {
+            throw std::overflow_error{"Value does not fit into a wide integer"};
+        }
+        for(unsigned limb = NUMBER_OF_LIMBS; limb-- > 1; ) {
+            limbs[limb] = (limbs[limb] << length) | (limbs[limb - 1] >> (LIMB_SIZE - length));
+        }
+        limbs[0] = (limbs[0] << length) | bits;
+        update_used_limbs();
+    }
+
+    WideInteger& operator+=(const WideInteger& rhs) {
+        if(Limb sum = 0; fits_in_64_bits() && rhs.fits_in_64_bits() && !checked_arithmetic::add_overflows(limbs[0], rhs.limbs[0], sum)) {
+            limbs[0] = sum;
+            return *this;
+        }
+        Limb carry = 0;
+        for(unsigned limb = 0; limb < NUMBER_OF_LIMBS; ++limb) {
+            limbs[limb] = checked_arithmetic::add_with_carry(limbs[limb], rhs.limbs[limb], carry);
+        }
+        if(carry != 0) {
+            throw std::overflow_error{"Sum does not fit into a wide integer"};
+        }
+        update_used_limbs();
+        return *this;
+    }
+
+    WideInteger& operator*=(const WideInteger& rhs) {
+        if(fits_in_64_bits() && rhs.fits_in_64_bits()) {
+            const auto product = checked_arithmetic::multiply_wide(limbs[0], rhs.limbs[0]);
+            limbs[0] = product.low;
+            limbs[1] = product.high;
+            used_limbs = limbs[1] != 0 ? 2 : 1;
+            return *this;
+        }
+        if(used_limbs + rhs.used_limbs > NUMBER_OF_LIMBS + 1) {
+            throw std::overflow_error{"Product does not fit into a wide integer"};
+        }
+        std::array<Limb, 2 * NUMBER_OF_LIMBS> product{};
+        for(unsigned i = 0; i < used_limbs; ++i) {
+            Limb carry = 0;
+            for(unsigned j = 0; j < rhs.used_limbs; ++j) {
+                // At most (2^64 - 1)^2 + 2 * (2^64 - 1), which still fits into 128 bits.
+                const auto partial = checked_arithmetic::add_wide(checked_arithmetic::add_wide(checked_arithmetic::multiply_wide(limbs[i], rhs.limbs[j]), product[i + j]), carry);
+                product[i + j] = partial.low;
+                carry = partial.high;
+            }
+            product[i + rhs.used_limbs] = carry;
+        }
+        if(std::any_of(std::begin(product) + NUMBER_OF_LIMBS, std::end(product), [](Limb limb) { return limb != 0; })) {
+            throw std::overflow_error{"Product does not fit into a wide integer"};
+        }
+        std::copy(std::begin(product), std::begin(product) + NUMBER_OF_LIMBS, std::begin(limbs));
+        update_used_limbs();
+        return *this;
+    }
+
+    friend WideInteger operator+(WideInteger lhs, const WideInteger& rhs) {
+        return lhs += rhs;
+    }
+
+    friend WideInteger operator*(WideInteger lhs, const WideInteger& rhs) {
+        return lhs *= rhs;
+    }
+
+    friend bool operator==(const WideInteger& lhs, const WideInteger& rhs) {
+        return lhs.limbs == rhs.limbs;
+    }
+
+    friend std::strong_ordering operator<=>(const WideInteger& lhs, const WideInteger& rhs) {
+        if(lhs.used_limbs != rhs.used_limbs) {
+            return lhs.used_limbs <=> rhs.used_limbs;
+        }
+        for(unsigned limb = lhs.used_limbs; limb-- > 0; ) {
+            if(lhs.limbs[limb] != rhs.limbs[limb]) {
+                return lhs.limbs[limb] <=> rhs.limbs[limb];
+            }
+        }
+        return std::strong_ordering::equal;
+    }
+
+    [[nodiscard]]
+    std::string to_string() const {
+        if(fits_in_64_bits()) {
+            return std::to_string(limbs[0]);
+        }
+        // Every remainder is below the chunk, so the quotient of the remainder and the next limb fits into one limb.
+        constexpr std::uint32_t DECIMAL_CHUNK = 1'000'000'000;
+        constexpr std::size_t DIGITS_PER_CHUNK = 9;
+        std::string digits{};
+        std::array<Limb, NUMBER_OF_LIMBS> quotient = limbs;
+        while(std::any_of(std::begin(quotient), std::end(quotient), [](Limb limb) { return limb != 0; })) {
+            Limb remainder = 0;
+            for(unsigned limb = NUMBER_OF_LIMBS; limb-- > 0; ) {
+                checked_arithmetic::DoubleWord dividend{remainder, quotient[limb]};
+                remainder = checked_arithmetic::divide(dividend, DECIMAL_CHUNK);
+                quotient[limb] = dividend.low;
+            }
+            std::string chunk = std::to_string(remainder);
+            const bool is_most_significant_chunk = std::all_of(std::begin(quotient), std::end(quotient), [](Limb limb) { return limb == 0; });
+            if(!is_most_significant_chunk) {
+                chunk.insert(0, DIGITS_PER_CHUNK - chunk.size(), '0');
+            }
+            digits.insert(0, chunk);
+        }
+        return digits;
+    }
+
+    friend std::ostream& operator<<(std::ostream& stream, const WideInteger& value) {
+        return stream << value.to_string();
+    }
+
+private:
+    std::array<Limb, NUMBER_OF_LIMBS> limbs{};
+    unsigned used_limbs = 1;
+
+    void update_used_limbs() {
+        used_limbs = NUMBER_OF_LIMBS;
+        while(used_limbs > 1 && limbs[used_limbs - 1] == 0) {
+            --used_limbs;
+        }
+    }
+};
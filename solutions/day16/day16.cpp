@@ -1,35 +1,240 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <numeric>
+#include <memory>
+#include <thread>
+#include <algorithm>
 #include <Utils.h>
-#include <Converters.h>
+#include <Benchmark.h>
 #include <PacketsParser.h>
+#include <StreamingPacketEvaluator.h>
+#include <WideInteger.h>
+#include <BatchTransmissionDecoder.h>
 
-std::string read_puzzle_input(const std::string& file_name) {
+std::ifstream open_puzzle_input(const std::string& file_name) {
     std::ifstream file{file_name};
     if(!file.is_open()) {
         throw std::runtime_error{"Could not open file " + file_name};
     }
+    return file;
+}
+
+std::string read_puzzle_input(const std::string& file_name) {
+    std::ifstream file = open_puzzle_input(file_name);
     std::string puzzle_input{};
     file >> puzzle_input;
     return utils::trim(puzzle_input);
 }
 
-unsigned solve_part_one(const std::string& hex_transmission) {
-    std::string binary_transmission = converters::hex_to_binary(hex_transmission);
-    const auto packet = PacketsParser::parse(binary_transmission);
-    return packet->get_version_sum();
+// Both parts decode the transmission straight from the file, it is never held in memory as a whole.
+unsigned solve_part_one(const std::string& file_name) {
+    std::ifstream file = open_puzzle_input(file_name);
+    StreamingVersionSummer version_summer{};
+    return version_summer.evaluate(file);
+}
+
+WideInteger solve_part_two(const std::string& file_name) {
+    std::ifstream file = open_puzzle_input(file_name);
+    WideStreamingPacketEvaluator evaluator{};
+    return evaluator.evaluate(file).value;
+}
+
+void report_packet_tree_evaluation(const std::string& hex_transmission) {
+    constexpr unsigned NUMBER_OF_REPETITIONS = 1000;
+    const auto packet = PacketsParser::parse(hex_transmission);
+    PacketTree packet_tree{};
+    PacketsParser::parse_into(hex_transmission, packet_tree);
+    long long pointer_tree_checksum = 0;
+    long long flat_tree_checksum = 0;
+    double pointer_tree_time = benchmark::measure_milliseconds([&]() {
+        for(unsigned repetition = 0; repetition < NUMBER_OF_REPETITIONS; ++repetition) {
+            pointer_tree_checksum += packet->get_value() + packet->get_version_sum();
+        }
+    });
+    double flat_tree_time = benchmark::measure_milliseconds([&]() {
+        for(unsigned repetition = 0; repetition < NUMBER_OF_REPETITIONS; ++repetition) {
+            flat_tree_checksum += packet_tree.get_value() + packet_tree.get_version_sum();
+        }
+    });
+    if(pointer_tree_checksum != flat_tree_checksum) {
+        throw std::runtime_error{"Flat packet tree evaluates differently than the pointer tree"};
+    }
+    std::cout << "Evaluating " << packet_tree.size() << " packets " << NUMBER_OF_REPETITIONS << " times, pointer tree: "
+              << pointer_tree_time << " ms, flat tree: " << flat_tree_time << " ms" << std::endl;
+}
+
+void write_bits(std::string& bits, unsigned long long value, unsigned length) {
+    for(unsigned bit = length; bit-- > 0; ) {
+        bits += ((value >> bit) & 1) ? '1' : '0';
+    }
+}
+
+void write_operator_packet_header(std::string& bits, unsigned type_id, unsigned number_of_sub_packets) {
+    write_bits(bits, 1, 3);
+    write_bits(bits, type_id, 3);
+    write_bits(bits, 1, 1);
+    write_bits(bits, number_of_sub_packets, 11);
+}
+
+void write_value_packet(std::string& bits, unsigned long long value, unsigned number_of_groups) {
+    write_bits(bits, 2, 3);
+    write_bits(bits, 4, 3);
+    for(unsigned group = number_of_groups; group-- > 0; ) {
+        write_bits(bits, group > 0 ? 1 : 0, 1);
+        write_bits(bits, value >> (4 * group), 4);
+    }
+}
+
+std::string bits_to_hex(std::string bits) {
+    bits.append((4 - bits.size() % 4) % 4, '0');
+    std::string hex_digits{};
+    for(std::size_t position = 0; position < bits.size(); position += 4) {
+        hex_digits += "0123456789ABCDEF"[std::stoul(bits.substr(position, 4), nullptr, 2)];
+    }
+    return hex_digits;
+}
+
+// Sum of sum packets, each of them holding values_per_group literals.
+std::string make_synthetic_transmission(unsigned number_of_groups, unsigned values_per_group) {
+    std::string bits{};
+    write_operator_packet_header(bits, 0, number_of_groups);
+    for(unsigned group = 0; group < number_of_groups; ++group) {
+        write_operator_packet_header(bits, 0, values_per_group);
+        for(unsigned value = 0; value < values_per_group; ++value) {
+            write_value_packet(bits, (group + value) % 16, 1);
+        }
+    }
+    return bits_to_hex(bits);
+}
+
+// Sum of products of four 60-bit literals, every product needs 240 bits.
+std::string make_wide_value_transmission(unsigned number_of_products) {
+    std::string bits{};
+    write_operator_packet_header(bits, 0, number_of_products);
+    for(unsigned product = 0; product < number_of_products; ++product) {
+        write_operator_packet_header(bits, 1, 4);
+        for(unsigned factor = 0; factor < 4; ++factor) {
+            write_value_packet(bits, 0xFEDCBA987654321ULL - product - factor, 15);
+        }
+    }
+    return bits_to_hex(bits);
+}
+
+void report_parsing_scaling() {
+    for(unsigned number_of_groups: {64u, 256u, 1024u, 2047u}) {
+        const auto hex_transmission = make_synthetic_transmission(number_of_groups, 2047);
+        std::unique_ptr<Packet> packet{};
+        PacketTree packet_tree{};
+        double pointer_tree_time = benchmark::measure_milliseconds([&]() { packet = PacketsParser::parse(hex_transmission); });
+        double flat_tree_time = benchmark::measure_milliseconds([&]() { PacketsParser::parse_into(hex_transmission, packet_tree); });
+        if(packet->get_value() != packet_tree.get_value()) {
+            throw std::runtime_error{"Flat packet tree evaluates differently than the pointer tree"};
+        }
+        const double size_in_mb = hex_transmission.size() / 1e6;
+        std::cout << "Parsing " << size_in_mb << " MB, pointer tree: " << pointer_tree_time << " ms (" << pointer_tree_time / size_in_mb
+                  << " ms/MB), flat tree: " << flat_tree_time << " ms (" << flat_tree_time / size_in_mb << " ms/MB)" << std::endl;
+    }
+}
+
+void report_streaming_evaluation() {
+    const auto hex_transmission = make_synthetic_transmission(2047, 2047);
+    PacketTree packet_tree{};
+    long long tree_value = 0;
+    double tree_time = benchmark::measure_milliseconds([&]() {
+        PacketsParser::parse_into(hex_transmission, packet_tree);
+        tree_value = packet_tree.get_value();
+    });
+    std::istringstream hex_stream{hex_transmission};
+    StreamingPacketEvaluator evaluator{};
+    StreamingPacketEvaluator::Result result{};
+    double streaming_time = benchmark::measure_milliseconds([&]() { result = evaluator.evaluate(hex_stream); });
+    if(result.value != tree_value || result.version_sum != packet_tree.get_version_sum()) {
+        throw std::runtime_error{"Streaming evaluation differs from the packet tree"};
+    }
+    std::cout << "Evaluating " << hex_transmission.size() / 1e6 << " MB, flat tree: " << tree_time
+              << " ms, streaming from a stream: " << streaming_time << " ms" << std::endl;
+}
+
+void report_value_paths() {
+    const auto narrow_transmission = make_synthetic_transmission(2047, 2047);
+    const auto wide_transmission = make_wide_value_transmission(2047);
+    StreamingPacketEvaluator evaluator{};
+    WideStreamingPacketEvaluator wide_evaluator{};
+    long long narrow_value = 0;
+    WideInteger wide_value{};
+    double narrow_time = benchmark::measure_milliseconds([&]() { narrow_value = evaluator.evaluate(narrow_transmission).value; });
+    double wide_time = benchmark::measure_milliseconds([&]() { wide_value = wide_evaluator.evaluate(narrow_transmission).value; });
+    if(!wide_value.fits_in_64_bits() || wide_value.low_64_bits() != static_cast<unsigned long long>(narrow_value)) {
+        throw std::runtime_error{"Wide evaluation differs from the 64-bit one"};
+    }
+    std::cout << "Values fitting into 64 bits, " << narrow_transmission.size() / 1e6 << " MB, 64-bit path: " << narrow_time
+              << " ms, wide path: " << wide_time << " ms" << std::endl;
+    try {
+        static_cast<void>(evaluator.evaluate(wide_transmission));
+        throw std::runtime_error{"64-bit evaluation did not detect the overflow"};
+    }
+    catch(const std::overflow_error&) {}
+    unsigned wide_version_sum = 0;
+    wide_time = benchmark::measure_milliseconds([&]() {
+        const auto result = wide_evaluator.evaluate(wide_transmission);
+        wide_value = result.value;
+        wide_version_sum = result.version_sum;
+    });
+    StreamingVersionSummer version_summer{};
+    if(version_summer.evaluate(wide_transmission) != wide_version_sum) {
+        throw std::runtime_error{"Version sum differs from the wide evaluation"};
+    }
+    std::cout << "Sum of " << 2047 << " products of 60-bit literals, " << wide_transmission.size() / 1e6 << " MB, 64-bit path: overflow, wide path: "
+              << wide_time << " ms, value " << wide_value << std::endl;
 }
 
-long long solve_part_two(const std::string& hex_transmission) {
-    std::string binary_transmission = converters::hex_to_binary(hex_transmission);
-    const auto packet = PacketsParser::parse(binary_transmission);
-    return packet->get_value();
+void report_batch_decoding() {
+    constexpr unsigned NUMBER_OF_TRANSMISSIONS = 1'000'000;
+    const std::vector<std::string> examples{
+        "C200B40A82", "04005AC33890", "880086C3E88112", "CE00C43D881120", "D8005AC2A8F0", "F600BC2D8F",
+        "9C005AC2F8F0", "9C0141080250320F1802104A08", "8A004A801A8002F478", "620080001611562C8802118E34",
+        "C0015000016115A2E0802F182340", "A0016C880162017C3686B18A3D4780"
+    };
+    std::string transmissions{};
+    for(unsigned transmission = 0; transmission < NUMBER_OF_TRANSMISSIONS; ++transmission) {
+        transmissions += examples[transmission % examples.size()];
+        transmissions += '\n';
+    }
+    std::vector<BatchTransmissionDecoder::Result> expected_results{};
+    PacketTree packet_tree{};
+    double hex_reader_time = benchmark::measure_milliseconds([&]() {
+        for(unsigned transmission = 0; transmission < NUMBER_OF_TRANSMISSIONS; ++transmission) {
+            PacketsParser::parse_into(examples[transmission % examples.size()], packet_tree);
+            expected_results.emplace_back(BatchTransmissionDecoder::Result{packet_tree.get_version_sum(), packet_tree.get_value()});
+        }
+    });
+    std::cout << "Decoding " << NUMBER_OF_TRANSMISSIONS << " transmissions one by one: " << NUMBER_OF_TRANSMISSIONS / hex_reader_time * 1000.0
+              << " transmissions/s" << std::endl;
+    for(unsigned number_of_threads = 1; number_of_threads <= std::thread::hardware_concurrency(); number_of_threads *= 2) {
+        BatchTransmissionDecoder decoder{number_of_threads};
+        std::vector<BatchTransmissionDecoder::Result> results{};
+        double time = benchmark::measure_milliseconds([&]() { results = decoder.decode(transmissions); });
+        const auto same_result = [](const auto& lhs, const auto& rhs) {
+            return lhs.version_sum == rhs.version_sum && lhs.value == rhs.value;
+        };
+        if(!std::equal(std::begin(results), std::end(results), std::begin(expected_results), std::end(expected_results), same_result)) {
+            throw std::runtime_error{"Batch decoding differs from decoding one by one"};
+        }
+        std::cout << "Batch decoding, threads: " << number_of_threads << ", " << NUMBER_OF_TRANSMISSIONS / time * 1000.0
+                  << " transmissions/s" << std::endl;
+    }
 }
 
-int main() {
-    const auto puzzle_input = read_puzzle_input("input.txt");
-    std::cout << "Part 1: " << solve_part_one(puzzle_input) << std::endl;
-    std::cout << "Part 2: " << solve_part_two(puzzle_input) << std::endl;
+int main(int argc, char** argv) {
+    std::cout << "Part 1: " << solve_part_one("input.txt") << std::endl;
+    std::cout << "Part 2: " << solve_part_two("input.txt") << std::endl;
+    if(benchmark::is_requested(argc, argv)) {
+        report_packet_tree_evaluation(read_puzzle_input("input.txt"));
+        report_parsing_scaling();
+        report_streaming_evaluation();
+        report_value_paths();
+        report_batch_decoding();
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include <SnailFishNumber.h>
+
+// Reduced snailfish number stored in the 16 leaf slots of a complete binary tree of depth 4.
+// A regular number at depth d sits in the first slot of the 2^(4 - d) slots below it, the remaining ones are empty,
+// so its depth follows from the distance to the next occupied slot and no structure has to be stored.
+// Splitting a number only fills an empty slot and a split at depth 4 explodes right away, no element ever moves.
+class CompactSnailFishNumber {
+public:
+
+    CompactSnailFishNumber() {
+        clear();
+    }
+
+    explicit CompactSnailFishNumber(const SnailFishNumber& number) : CompactSnailFishNumber() {
+        for(const auto& element: number.regular_numbers()) {
+            append(element.value, element.depth);
+        }
+    }
+
+    void clear() {
+        slots.fill(EMPTY);
+        next_free_slot = 0;
+    }
+
+    // Regular numbers have to be appended from left to right.
+    void append(unsigned value, unsigned depth) {
+        if(depth > MAXIMAL_DEPTH || next_free_slot >= NUMBER_OF_SLOTS || value >= EMPTY) {
+            throw std::runtime_error{"Snailfish number does not fit into the compact representation"};
+        }
+        slots[next_free_slot] = static_cast<Slot>(value);
+        next_free_slot += 1u << (MAXIMAL_DEPTH - depth);
+    }
+
+    CompactSnailFishNumber operator+(const CompactSnailFishNumber& rhs) const {
+        CompactSnailFishNumber result{*this};
+        result += rhs;
+        return result;
+    }
+
+    CompactSnailFishNumber& operator+=(const CompactSnailFishNumber& rhs) {
+        explode_sum(rhs);
+        split_all();
+        return *this;
+    }
+
+    [[nodiscard]]
+    unsigned magnitude() const {
+        return magnitude_of_subtree(0, NUMBER_OF_SLOTS);
+    }
+
+    [[nodiscard]]
+    unsigned regular_number_sum() const {
+        unsigned sum = 0;
+        for(const Slot value: slots) {
+            sum += value == EMPTY ? 0 : value;
+        }
+        return sum;
+    }
+
+    // Reduction never increases the sum of the regular numbers and leaves them below 10, a regular number
+    // counts at most as much as a depth 4 leaf with the same path prefix. Packing the sum in nines into the
+    // heaviest depth 4 leaves therefore bounds the magnitude of any reduced number with that sum.
+    [[nodiscard]]
+    static unsigned maximal_magnitude_for_regular_number_sum(unsigned sum) {
+        constexpr std::array<unsigned, MAXIMAL_DEPTH + 1> LEAVES_WITH_NUMBER_OF_LEFT_TURNS{1, 4, 6, 4, 1};
+        unsigned magnitude = 0;
+        for(int left_turns = MAXIMAL_DEPTH; left_turns >= 0 && sum > 0; --left_turns) {
+            unsigned weight = 1;
+            for(int level = 0; level < static_cast<int>(MAXIMAL_DEPTH); ++level) {
+                weight *= level < left_turns ? 3 : 2;
+            }
+            const unsigned packed = std::min(sum, 9 * LEAVES_WITH_NUMBER_OF_LEFT_TURNS[left_turns]);
+            magnitude += packed * weight;
+            sum -= packed;
+        }
+        return magnitude;
+    }
+
+private:
+    using Slot = std::uint8_t;
+    static constexpr unsigned MAXIMAL_DEPTH = 4;
+    static constexpr unsigned NUMBER_OF_SLOTS = 1u << MAXIMAL_DEPTH;
+    static constexpr Slot EMPTY = 0xFF;
+
+    std::array<Slot, NUMBER_OF_SLOTS> slots{};
+    unsigned next_free_slot{};
+
+    [[nodiscard]]
+    inline unsigned next_occupied_slot(unsigned slot) const {
+        for(++slot; slot < NUMBER_OF_SLOTS && slots[slot] == EMPTY; ++slot) {}
+        return slot;
+    }
+
+    [[nodiscard]]
+    inline int previous_occupied_slot(unsigned slot) const {
+        int previous = static_cast<int>(slot) - 1;
+        for(; previous >= 0 && slots[previous] == EMPTY; --previous) {}
+        return previous;
+    }
+
+    // Both operands are laid out side by side in 32 slots one level deeper, every pair that ends up at depth 5
+    // occupies two neighbouring slots. Those pairs explode from left to right, afterwards every other slot is empty.
+    void explode_sum(const CompactSnailFishNumber& rhs) {
+        std::array<Slot, 2 * NUMBER_OF_SLOTS> sum{};
+        std::copy(std::begin(slots), std::end(slots), std::begin(sum));
+        std::copy(std::begin(rhs.slots), std::end(rhs.slots), std::begin(sum) + NUMBER_OF_SLOTS);
+        int last_occupied = -1;
+        for(unsigned slot = 0; slot < sum.size(); slot += 2) {
+            if(sum[slot] == EMPTY) {
+                continue;
+            }
+            if(sum[slot + 1] != EMPTY) {
+                if(last_occupied >= 0) {
+                    sum[last_occupied] += sum[slot];
+                }
+                unsigned next = slot + 2;
+                for(; next < sum.size() && sum[next] == EMPTY; ++next) {}
+                if(next < sum.size()) {
+                    sum[next] += sum[slot + 1];
+                }
+                sum[slot] = 0;
+                sum[slot + 1] = EMPTY;
+            }
+            last_occupied = static_cast<int>(slot);
+        }
+        for(unsigned slot = 0; slot < NUMBER_OF_SLOTS; ++slot) {
+            slots[slot] = sum[2 * slot];
+        }
+    }
+
+    // Splits the leftmost regular number of 10 or more until there is none. A number covering several slots
+    // becomes a pair in place, a number at depth 4 would become a pair at depth 5 which explodes immediately,
+    // only its left neighbour can then turn into the leftmost number to split.
+    void split_all() {
+        for(unsigned slot = 0; slot < NUMBER_OF_SLOTS; ) {
+            const Slot value = slots[slot];
+            if(value == EMPTY || value < 10) {
+                ++slot;
+                continue;
+            }
+            const Slot rounded_down = value / 2;
+            const Slot rounded_up = value - rounded_down;
+            const unsigned width = next_occupied_slot(slot) - slot;
+            if(width > 1) {
+                slots[slot] = rounded_down;
+                slots[slot + width / 2] = rounded_up;
+                continue;
+            }
+            const int previous = previous_occupied_slot(slot);
+            const unsigned next = next_occupied_slot(slot);
+            if(next < NUMBER_OF_SLOTS) {
+                slots[next] += rounded_up;
+            }
+            slots[slot] = 0;
+            if(previous >= 0) {
+                slots[previous] += rounded_down;
+                slot = previous;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    unsigned magnitude_of_subtree(unsigned first_slot, unsigned width) const {
+        if(slots[first_slot] != EMPTY && next_occupied_slot(first_slot) >= first_slot + width) {
+            return slots[first_slot];
+        }
+        return 3 * magnitude_of_subtree(first_slot, width / 2) + 2 * magnitude_of_subtree(first_slot + width / 2, width / 2);
+    }
+};
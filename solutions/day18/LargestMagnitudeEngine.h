@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <algorithm>
+#include <thread>
+
+#include <ThreadPool.h>
+#include <CompactSnailFishNumber.h>
+
+// Searches the largest magnitude of a sum of two different numbers in both orders.
+// Every task takes the numbers as first operand one after another, the sums are built in a scratch number on the stack.
+// With pruning the operands are visited by descending sum of their regular numbers, a row stops as soon as the
+// upper bound of the magnitude can not beat the best magnitude found so far by any thread.
+class LargestMagnitudeEngine {
+public:
+
+    explicit LargestMagnitudeEngine(const std::vector<CompactSnailFishNumber>& numbers,
+                                    unsigned number_of_threads = std::thread::hardware_concurrency(), bool use_pruning = true) :
+        numbers{numbers},
+        thread_pool{number_of_threads > 1 ? std::make_unique<ThreadPool>(number_of_threads) : nullptr},
+        use_pruning{use_pruning},
+        order(numbers.size()),
+        regular_number_sums(numbers.size()) {
+        std::iota(std::begin(order), std::end(order), 0u);
+        for(unsigned index = 0; index < numbers.size(); ++index) {
+            regular_number_sums[index] = numbers[index].regular_number_sum();
+        }
+        if(use_pruning) {
+            std::stable_sort(std::begin(order), std::end(order), [this](unsigned lhs, unsigned rhs) {
+                return regular_number_sums[lhs] > regular_number_sums[rhs];
+            });
+        }
+    }
+
+    [[nodiscard]]
+    unsigned find_largest_magnitude() {
+        largest_magnitude.store(0);
+        number_of_additions.store(0);
+        const auto row_task = [this](unsigned row) { search_row(order[row]); };
+        if(thread_pool) {
+            thread_pool->run_and_wait(numbers.size(), row_task);
+        }
+        else {
+            for(unsigned row = 0; row < numbers.size(); ++row) {
+                row_task(row);
+            }
+        }
+        return largest_magnitude.load();
+    }
+
+    [[nodiscard]]
+    inline unsigned long long number_of_additions_in_last_search() const {
+        return number_of_additions.load();
+    }
+
+private:
+    const std::vector<CompactSnailFishNumber>& numbers;
+    std::unique_ptr<ThreadPool> thread_pool{};
+    bool use_pruning{};
+    std::vector<unsigned> order{};
+    std::vector<unsigned> regular_number_sums{};
+    std::atomic<unsigned> largest_magnitude{0};
+    std::atomic<unsigned long long> number_of_additions{0};
+
+    void search_row(unsigned first) {
+        unsigned best_in_row = 0;
+        unsigned long long additions_in_row = 0;
+        for(const unsigned second: order) {
+            if(second == first) {
+                continue;
+            }
+            if(use_pruning && upper_bound(first, second) <= std::max(best_in_row, largest_magnitude.load(std::memory_order_relaxed))) {
+                break;
+            }
+            CompactSnailFishNumber sum{numbers[first]};
+            sum += numbers[second];
+            best_in_row = std::max(best_in_row, sum.magnitude());
+            ++additions_in_row;
+        }
+        number_of_additions += additions_in_row;
+        for(unsigned current = largest_magnitude.load(); best_in_row > current && !largest_magnitude.compare_exchange_weak(current, best_in_row); ) {}
+    }
+
+    [[nodiscard]]
+    inline unsigned upper_bound(unsigned first, unsigned second) const {
+        return CompactSnailFishNumber::maximal_magnitude_for_regular_number_sum(regular_number_sums[first] + regular_number_sums[second]);
+    }
+};
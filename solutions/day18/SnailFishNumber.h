@@ -0,0 +1,179 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+struct RegularNumber {
+    unsigned value = 0;
+    unsigned depth = 0;
+};
+
+struct RegularNumberDepthComparator {
+    bool operator()(const RegularNumber& lhs, const RegularNumber& rhs) {
+        return lhs.depth < rhs.depth;
+    }
+};
+
+class SnailFishNumber {
+public:
+
+    explicit SnailFishNumber(std::vector<RegularNumber> elements) :
+        elements{std::move(elements)} {}
+
+    SnailFishNumber operator+(const SnailFishNumber& rhs) const {
+        std::vector<RegularNumber> elements_of_the_result{};
+        elements_of_the_result.reserve(elements.size() + rhs.elements.size());
+        elements_of_the_result.insert(std::end(elements_of_the_result), std::begin(elements), std::end(elements));
+        elements_of_the_result.insert(std::end(elements_of_the_result), std::begin(rhs.elements), std::end(rhs.elements));
+        std::for_each(std::begin(elements_of_the_result), std::end(elements_of_the_result), [](RegularNumber& element) { ++(element.depth); });
+        SnailFishNumber result{elements_of_the_result};
+        result.reduce();
+        return result;
+    }
+
+    [[nodiscard]]
+    unsigned magnitude() const {
+        static RegularNumberDepthComparator depth_comparator{};
+        std::vector<RegularNumber> magnitudes_with_depths = elements;
+        unsigned deepest_level = std::max_element(std::begin(elements), std::end(elements), depth_comparator)->depth;
+        while(magnitudes_with_depths.size() > 1) {
+            unsigned number_of_magnitudes = magnitudes_with_depths.size();
+            unsigned number_of_removed = 0;
+            for(unsigned i = 0; i < number_of_magnitudes - number_of_removed; ++i) {
+                if(magnitudes_with_depths.at(i).depth == deepest_level) {
+                    RegularNumber new_magnitude_with_depth{
+                        3 * magnitudes_with_depths.at(i).value + 2 * magnitudes_with_depths.at(i + 1).value,
+                        magnitudes_with_depths.at(i).depth - 1
+                    };
+                    magnitudes_with_depths.at(i) = new_magnitude_with_depth;
+                    magnitudes_with_depths.erase(std::begin(magnitudes_with_depths) + i + 1);
+                    ++number_of_removed;
+                }
+            }
+            --deepest_level;
+        }
+        return magnitudes_with_depths.empty() ? 0 : magnitudes_with_depths.at(0).value;
+    }
+
+    [[nodiscard]]
+    inline const std::vector<RegularNumber>& regular_numbers() const {
+        return elements;
+    }
+
+private:
+    std::vector<RegularNumber> elements{};
+
+    [[nodiscard]]
+    bool explode_if_possible() {
+        for(unsigned index = 0; index < elements.size() - 1; ++index) {
+            if(elements.at(index).depth != 5) {
+                continue;
+            }
+            RegularNumber first_number = elements.at(index);
+            RegularNumber second_number = elements.at(index + 1);
+            elements.at(index) = {0, first_number.depth - 1};
+            if(index != 0) {
+                elements.at(index - 1).value += first_number.value;
+            }
+            if(index + 1 < elements.size() - 1) {
+                elements.at(index + 2).value += second_number.value;
+            }
+            elements.erase(std::begin(elements) + index + 1);
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]]
+    bool split_if_possible() {
+        for(unsigned index = 0; index < elements.size(); ++index) {
+            if(elements.at(index).value < 10) {
+                continue;
+            }
+            RegularNumber to_split = elements.at(index);
+            RegularNumber rounded_down{static_cast<unsigned>(std::floor(to_split.value / 2.0)), to_split.depth + 1};
+            RegularNumber rounded_up{static_cast<unsigned>(std::ceil(to_split.value / 2.0)), to_split.depth + 1};
+            elements.insert(std::begin(elements) + index, rounded_down);
+            elements.at(index + 1) = rounded_up;
+            return true;
+        }
+        return false;
+    }
+
+    void reduce_step_by_step() {
+        for(bool reduced = true; reduced; ) {
+            reduced = explode_if_possible();
+            if(!reduced) {
+                reduced = split_if_possible();
+            }
+        }
+    }
+
+    // A sum of two reduced numbers nests at most 5 levels deep, so every pair to explode is a pair of
+    // regular numbers. They are all exploded in one left to right pass, splits are handled afterwards.
+    void reduce() {
+        static RegularNumberDepthComparator depth_comparator{};
+        if(elements.empty() || std::max_element(std::begin(elements), std::end(elements), depth_comparator)->depth > 5) {
+            reduce_step_by_step();
+            return;
+        }
+        explode_all();
+        split_all();
+    }
+
+    void explode_all() {
+        std::vector<RegularNumber> exploded{};
+        exploded.reserve(elements.size());
+        unsigned carried_value = 0;
+        for(unsigned index = 0; index < elements.size(); ++index) {
+            RegularNumber element = elements[index];
+            element.value += carried_value;
+            carried_value = 0;
+            if(element.depth != 5) {
+                exploded.push_back(element);
+                continue;
+            }
+            if(!exploded.empty()) {
+                exploded.back().value += element.value;
+            }
+            carried_value = elements.at(index + 1).value;
+            exploded.push_back({0, element.depth - 1});
+            ++index;
+        }
+        elements = std::move(exploded);
+    }
+
+    // Elements left of the cursor are all below 10, the ones right of it are kept on a stack in reversed order.
+    // A split that creates a pair at depth 5 explodes right away and the left neighbour is checked again.
+    void split_all() {
+        std::vector<RegularNumber> checked{};
+        checked.reserve(elements.size());
+        std::vector<RegularNumber> unchecked(std::rbegin(elements), std::rend(elements));
+        while(!unchecked.empty()) {
+            RegularNumber element = unchecked.back();
+            unchecked.pop_back();
+            if(element.value < 10) {
+                checked.push_back(element);
+                continue;
+            }
+            RegularNumber rounded_down{element.value / 2, element.depth + 1};
+            RegularNumber rounded_up{element.value - rounded_down.value, element.depth + 1};
+            if(rounded_down.depth < 5) {
+                unchecked.push_back(rounded_up);
+                unchecked.push_back(rounded_down);
+                continue;
+            }
+            if(!unchecked.empty()) {
+                unchecked.back().value += rounded_up.value;
+            }
+            unchecked.push_back({0, element.depth});
+            if(!checked.empty()) {
+                checked.back().value += rounded_down.value;
+                unchecked.push_back(checked.back());
+                checked.pop_back();
+            }
+        }
+        elements = std::move(checked);
+    }
+};
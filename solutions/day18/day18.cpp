@@ -1,111 +1,16 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <iterator>
 #include <vector>
 #include <cmath>
 #include <numeric>
+#include <thread>
 #include <Utils.h>
-
-struct RegularNumber {
-    unsigned value = 0;
-    unsigned depth = 0;
-};
-
-struct RegularNumberDepthComparator {
-    bool operator()(const RegularNumber& lhs, const RegularNumber& rhs) {
-        return lhs.depth < rhs.depth;
-    }
-};
-
-class SnailFishNumber {
-public:
-
-    explicit SnailFishNumber(std::vector<RegularNumber> elements) :
-        elements{std::move(elements)} {}
-
-    SnailFishNumber operator+(const SnailFishNumber& rhs) const {
-        std::vector<RegularNumber> elements_of_the_result{};
-        elements_of_the_result.reserve(elements.size() + rhs.elements.size());
-        elements_of_the_result.insert(std::end(elements_of_the_result), std::begin(elements), std::end(elements));
-        elements_of_the_result.insert(std::end(elements_of_the_result), std::begin(rhs.elements), std::end(rhs.elements));
-        std::for_each(std::begin(elements_of_the_result), std::end(elements_of_the_result), [](RegularNumber& element) { ++(element.depth); });
-        SnailFishNumber result{elements_of_the_result};
-        result.reduce();
-        return result;
-    }
-
-    [[nodiscard]]
-    unsigned magnitude() const {
-        static RegularNumberDepthComparator depth_comparator{};
-        std::vector<RegularNumber> magnitudes_with_depths = elements;
-        unsigned deepest_level = std::max_element(std::begin(elements), std::end(elements), depth_comparator)->depth;
-        while(magnitudes_with_depths.size() > 1) {
-            unsigned number_of_magnitudes = magnitudes_with_depths.size();
-            unsigned number_of_removed = 0;
-            for(unsigned i = 0; i < number_of_magnitudes - number_of_removed; ++i) {
-                if(magnitudes_with_depths.at(i).depth == deepest_level) {
-                    RegularNumber new_magnitude_with_depth{
-                        3 * magnitudes_with_depths.at(i).value + 2 * magnitudes_with_depths.at(i + 1).value,
-                        magnitudes_with_depths.at(i).depth - 1
-                    };
-                    magnitudes_with_depths.at(i) = new_magnitude_with_depth;
-                    magnitudes_with_depths.erase(std::begin(magnitudes_with_depths) + i + 1);
-                    ++number_of_removed;
-                }
-            }
-            --deepest_level;
-        }
-        return magnitudes_with_depths.empty() ? 0 : magnitudes_with_depths.at(0).value;
-    }
-
-private:
-    std::vector<RegularNumber> elements{};
-
-    [[nodiscard]]
-    bool explode_if_possible() {
-        for(unsigned index = 0; index < elements.size() - 1; ++index) {
-            if(elements.at(index).depth != 5) {
-                continue;
-            }
-            RegularNumber first_number = elements.at(index);
-            RegularNumber second_number = elements.at(index + 1);
-            elements.at(index) = {0, first_number.depth - 1};
-            if(index != 0) {
-                elements.at(index - 1).value += first_number.value;
-            }
-            if(index + 1 < elements.size() - 1) {
-                elements.at(index + 2).value += second_number.value;
-            }
-            elements.erase(std::begin(elements) + index + 1);
-            return true;
-        }
-        return false;
-    }
-
-    [[nodiscard]]
-    bool split_if_possible() {
-        for(unsigned index = 0; index < elements.size(); ++index) {
-            if(elements.at(index).value < 10) {
-                continue;
-            }
-            RegularNumber to_split = elements.at(index);
-            RegularNumber rounded_down{static_cast<unsigned>(std::floor(to_split.value / 2.0)), to_split.depth + 1};
-            RegularNumber rounded_up{static_cast<unsigned>(std::ceil(to_split.value / 2.0)), to_split.depth + 1};
-            elements.insert(std::begin(elements) + index, rounded_down);
-            elements.at(index + 1) = rounded_up;
-            return true;
-        }
-        return false;
-    }
-
-    void reduce() {
-        for(bool reduced = true; reduced; ) {
-            reduced = explode_if_possible();
-            if(!reduced) {
-                reduced = split_if_possible();
-            }
-        }
-    }
-};
+#include <Benchmark.h>
+#include <SnailFishNumber.h>
+#include <CompactSnailFishNumber.h>
+#include <LargestMagnitudeEngine.h>
 
 SnailFishNumber parse_snail_fish_number(const std::string& string_representation) {
     unsigned current_depth = 0;
@@ -137,6 +42,32 @@ SnailFishNumber parse_snail_fish_number(const std::string& string_representation
     return SnailFishNumber{elements};
 }
 
+// Parses into the given number, so a single number can be reused for every line.
+void parse_compact_snail_fish_number(const std::string& string_representation, CompactSnailFishNumber& number) {
+    number.clear();
+    unsigned current_depth = 0;
+    unsigned current_number = 0;
+    bool has_current_number = false;
+    for(char character: string_representation) {
+        if(character >= '0' && character <= '9') {
+            current_number = current_number * 10 + (character - '0');
+            has_current_number = true;
+            continue;
+        }
+        if(has_current_number) {
+            number.append(current_number, current_depth);
+            current_number = 0;
+            has_current_number = false;
+        }
+        if(character == '[') {
+            ++current_depth;
+        }
+        else if(character == ']') {
+            --current_depth;
+        }
+    }
+}
+
 std::vector<SnailFishNumber> read_puzzle_input(const std::string& file_name) {
     std::ifstream file{file_name};
     if(!file.is_open()) {
@@ -150,26 +81,130 @@ std::vector<SnailFishNumber> read_puzzle_input(const std::string& file_name) {
     return puzzle_input;
 }
 
-unsigned solve_part_one(const std::vector<SnailFishNumber>& puzzle_input) {
+std::vector<CompactSnailFishNumber> to_compact_numbers(const std::vector<SnailFishNumber>& numbers) {
+    std::vector<CompactSnailFishNumber> compact_numbers{};
+    compact_numbers.reserve(numbers.size());
+    for(const auto& number: numbers) {
+        compact_numbers.emplace_back(number);
+    }
+    return compact_numbers;
+}
+
+template<typename Number>
+unsigned solve_part_one(const std::vector<Number>& puzzle_input) {
     auto addition_result = std::accumulate(std::begin(puzzle_input) + 1, std::end(puzzle_input), puzzle_input.front());
     return addition_result.magnitude();
 }
 
-unsigned solve_part_two(const std::vector<SnailFishNumber>& puzzle_input) {
-    unsigned highest_magnitude = 0;
-    for(unsigned i = 0; i < puzzle_input.size() - 1; ++i) {
-        for(unsigned j = i + 1; j < puzzle_input.size(); ++j) {
-            unsigned magnitude_in_order = (puzzle_input.at(i) + puzzle_input.at(j)).magnitude();
-            unsigned magnitude_reversed = (puzzle_input.at(j) + puzzle_input.at(i)).magnitude();
-            highest_magnitude = std::max(highest_magnitude, std::max(magnitude_in_order, magnitude_reversed));
+// Folds the numbers into the sum while reading them, only the current line and two numbers are kept in memory.
+unsigned solve_part_one_streaming(std::istream& input) {
+    CompactSnailFishNumber sum{};
+    CompactSnailFishNumber addend{};
+    bool is_first_number = true;
+    for(std::string input_line; std::getline(input, input_line); ) {
+        if(input_line.find('[') == std::string::npos) {
+            continue;
         }
+        parse_compact_snail_fish_number(input_line, is_first_number ? sum : addend);
+        if(!is_first_number) {
+            sum += addend;
+        }
+        is_first_number = false;
+    }
+    return sum.magnitude();
+}
+
+unsigned solve_part_one_streaming(const std::string& file_name) {
+    std::ifstream file{file_name};
+    if(!file.is_open()) {
+        throw std::runtime_error{"Could not open file " + file_name};
     }
-    return highest_magnitude;
+    return solve_part_one_streaming(file);
 }
 
-int main() {
+unsigned solve_part_two(const std::vector<CompactSnailFishNumber>& puzzle_input) {
+    LargestMagnitudeEngine engine{puzzle_input};
+    return engine.find_largest_magnitude();
+}
+
+template<typename Number>
+void report_long_sum_throughput(const std::vector<Number>& puzzle_input, const std::string& representation) {
+    constexpr unsigned NUMBER_OF_REPETITIONS = 100;
+    std::vector<Number> long_sum{};
+    for(unsigned repetition = 0; repetition < NUMBER_OF_REPETITIONS; ++repetition) {
+        long_sum.insert(std::end(long_sum), std::begin(puzzle_input), std::end(puzzle_input));
+    }
+    unsigned magnitude = 0;
+    double time = benchmark::measure_milliseconds([&]() { magnitude = solve_part_one(long_sum); });
+    std::cout << representation << " sum of " << long_sum.size() << " numbers: magnitude " << magnitude << ", " << time << " ms, "
+              << (long_sum.size() - 1) / time * 1000.0 << " additions/s" << std::endl;
+}
+
+void report_streaming_sum_throughput(const std::string& file_name) {
+    constexpr unsigned NUMBER_OF_REPETITIONS = 100;
+    std::ifstream file{file_name};
+    const std::string file_content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    std::string long_sum{};
+    for(unsigned repetition = 0; repetition < NUMBER_OF_REPETITIONS; ++repetition) {
+        long_sum += file_content;
+        if(!long_sum.empty() && long_sum.back() != '\n') {
+            long_sum += '\n';
+        }
+    }
+    std::istringstream input{long_sum};
+    unsigned magnitude = 0;
+    double time = benchmark::measure_milliseconds([&]() { magnitude = solve_part_one_streaming(input); });
+    std::cout << "Streaming sum of " << NUMBER_OF_REPETITIONS << " copies of the input: magnitude " << magnitude << ", "
+              << time << " ms, " << long_sum.size() / time / 1000.0 << " MB/s" << std::endl;
+}
+
+// Extends the input with sums of two of its numbers, which are reduced snailfish numbers as well.
+std::vector<CompactSnailFishNumber> make_operands(const std::vector<CompactSnailFishNumber>& puzzle_input, std::size_t number_of_operands) {
+    std::vector<CompactSnailFishNumber> operands{puzzle_input};
+    for(std::size_t offset = 1; !puzzle_input.empty() && operands.size() < number_of_operands; ++offset) {
+        for(std::size_t first = 0; first < puzzle_input.size() && operands.size() < number_of_operands; ++first) {
+            operands.emplace_back(puzzle_input[first] + puzzle_input[(first + offset) % puzzle_input.size()]);
+        }
+    }
+    operands.resize(number_of_operands);
+    return operands;
+}
+
+void report_largest_magnitude_search(const std::vector<CompactSnailFishNumber>& puzzle_input) {
+    constexpr std::size_t NUMBER_OF_OPERANDS = 1000;
+    const auto operands = make_operands(puzzle_input, NUMBER_OF_OPERANDS);
+    std::cout << "Largest magnitude search over " << operands.size() << " operands" << std::endl;
+    unsigned expected_magnitude = 0;
+    double single_thread_time = 0.0;
+    for(bool use_pruning: {false, true}) {
+        for(unsigned number_of_threads = 1; number_of_threads <= std::thread::hardware_concurrency(); number_of_threads *= 2) {
+            LargestMagnitudeEngine engine{operands, number_of_threads, use_pruning};
+            unsigned magnitude = 0;
+            double time = benchmark::measure_milliseconds([&]() { magnitude = engine.find_largest_magnitude(); });
+            if(!use_pruning && number_of_threads == 1) {
+                expected_magnitude = magnitude;
+                single_thread_time = time;
+            }
+            else if(magnitude != expected_magnitude) {
+                throw std::runtime_error{"Largest magnitude differs from the serial unpruned search"};
+            }
+            std::cout << "Pruning: " << (use_pruning ? "on" : "off") << ", threads: " << number_of_threads
+                      << ", additions: " << engine.number_of_additions_in_last_search() << ", time: " << time
+                      << " ms, speedup: " << single_thread_time / time << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
     const auto puzzle_input = read_puzzle_input("input.txt");
-    std::cout << "Part 1: " << solve_part_one(puzzle_input) << std::endl;
-    std::cout << "Part 2: " << solve_part_two(puzzle_input) << std::endl;
+    const auto compact_puzzle_input = to_compact_numbers(puzzle_input);
+    std::cout << "Part 1: " << solve_part_one_streaming("input.txt") << std::endl;
+    std::cout << "Part 2: " << solve_part_two(compact_puzzle_input) << std::endl;
+    if(benchmark::is_requested(argc, argv)) {
+        report_long_sum_throughput(puzzle_input, "Vector");
+        report_long_sum_throughput(compact_puzzle_input, "Compact");
+        report_streaming_sum_throughput("input.txt");
+        report_largest_magnitude_search(compact_puzzle_input);
+    }
     return 0;
 }
\ No newline at end of file
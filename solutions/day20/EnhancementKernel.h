@@ -0,0 +1,251 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <algorithm>
+#include <vector>
+#include <stdexcept>
+
+#include <Image.h>
+
+namespace enhancement_kernel {
+
+using Word = Image::Word;
+using EnhancementLookup = std::array<bool, 512>;
+
+constexpr unsigned WORD_SIZE = Image::WORD_SIZE;
+constexpr unsigned WINDOW_SIDE = 3;
+
+// Rows above, at and below the row being enhanced, nullptr rows read as out of bounds.
+using RowNeighbourhood = std::array<const Word*, WINDOW_SIDE>;
+
+EnhancementLookup make_lookup(const std::vector<bool>& algorithm) {
+    EnhancementLookup lookup{};
+    if(algorithm.size() != lookup.size()) {
+        throw std::runtime_error{"Image enhancement algorithm has to have 512 entries"};
+    }
+    std::copy(std::begin(algorithm), std::end(algorithm), std::begin(lookup));
+    return lookup;
+}
+
+// The rule as a boolean function of the nine pixels of a 3x3 window, evaluated for 64 neighbouring windows at once.
+// Plane i holds pixel i of every window, in the order of the index bits from the most significant one.
+// The three pixels of a window row take eight values, the mask of windows with a given row value is an AND of three
+// planes. For every value of the top and middle rows the rule is a function of the bottom row value, an OR of the
+// masks of the bottom row values it maps to one. It is split into the ORs over the low and the high four values,
+// all 16 of each are built per word. The new pixels are then an OR over the 64 upper row values.
+class BitSlicedRule {
+public:
+    using WindowPlanes = std::array<Word, WINDOW_SIDE * WINDOW_SIDE>;
+
+    explicit BitSlicedRule(const EnhancementLookup& lookup) {
+        for(unsigned upper_rows = 0; upper_rows < NUMBER_OF_UPPER_ROW_VALUES; ++upper_rows) {
+            for(unsigned bottom_row = 0; bottom_row < NUMBER_OF_ROW_VALUES; ++bottom_row) {
+                bottom_row_functions[upper_rows] |= static_cast<unsigned char>(lookup[upper_rows * NUMBER_OF_ROW_VALUES + bottom_row]) << bottom_row;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    Word operator()(const WindowPlanes& planes) const {
+        const auto top = row_value_masks(planes, 0);
+        const auto middle = row_value_masks(planes, 3);
+        const auto bottom = row_value_masks(planes, 6);
+        // Entry s holds the windows whose bottom row value is the first or the last four values picked by the bits of s.
+        std::array<Word, NUMBER_OF_HALF_FUNCTIONS> low_functions{};
+        std::array<Word, NUMBER_OF_HALF_FUNCTIONS> high_functions{};
+        for(unsigned selection = 1; selection < NUMBER_OF_HALF_FUNCTIONS; ++selection) {
+            const unsigned lowest_value = std::countr_zero(selection);
+            low_functions[selection] = low_functions[selection & (selection - 1)] | bottom[lowest_value];
+            high_functions[selection] = high_functions[selection & (selection - 1)] | bottom[HALF_FUNCTION_BITS + lowest_value];
+        }
+        Word new_pixels = 0;
+        for(unsigned top_row = 0; top_row < NUMBER_OF_ROW_VALUES; ++top_row) {
+            Word upper_rows_pixels = 0;
+            for(unsigned middle_row = 0; middle_row < NUMBER_OF_ROW_VALUES; ++middle_row) {
+                const unsigned function = bottom_row_functions[top_row * NUMBER_OF_ROW_VALUES + middle_row];
+                upper_rows_pixels |= middle[middle_row] & (low_functions[function % NUMBER_OF_HALF_FUNCTIONS] | high_functions[function / NUMBER_OF_HALF_FUNCTIONS]);
+            }
+            new_pixels |= top[top_row] & upper_rows_pixels;
+        }
+        return new_pixels;
+    }
+
+private:
+    static constexpr unsigned NUMBER_OF_ROW_VALUES = 8;
+    static constexpr unsigned NUMBER_OF_UPPER_ROW_VALUES = NUMBER_OF_ROW_VALUES * NUMBER_OF_ROW_VALUES;
+    static constexpr unsigned HALF_FUNCTION_BITS = NUMBER_OF_ROW_VALUES / 2;
+    static constexpr unsigned NUMBER_OF_HALF_FUNCTIONS = 1u << HALF_FUNCTION_BITS;
+
+    using RowValueMasks = std::array<Word, NUMBER_OF_ROW_VALUES>;
+
+    // Truth tables over the bottom row value for every value of the upper rows, bit v is the new pixel when the
+    // bottom row has value v.
+    std::array<unsigned char, NUMBER_OF_UPPER_ROW_VALUES> bottom_row_functions{};
+
+    [[nodiscard]]
+    static inline RowValueMasks row_value_masks(const WindowPlanes& planes, unsigned first_plane) {
+        const std::array<Word, 2> left{~planes[first_plane], planes[first_plane]};
+        const std::array<Word, 2> centre{~planes[first_plane + 1], planes[first_plane + 1]};
+        const std::array<Word, 2> right{~planes[first_plane + 2], planes[first_plane + 2]};
+        RowValueMasks masks{};
+        for(unsigned value = 0; value < NUMBER_OF_ROW_VALUES; ++value) {
+            masks[value] = left[value >> 2] & centre[(value >> 1) & 1] & right[value & 1];
+        }
+        return masks;
+    }
+};
+
+// The rule applied to a 4x4 window, memoized for all 65536 windows, which yields the 2x2 pixels at its centre.
+// Nibble r of a window index holds window row r, its lowest bit is the leftmost pixel as in image words. Bits 0 and 1
+// of an entry are the upper new pixels, bits 2 and 3 the lower ones, again from the left.
+class BlockRule {
+public:
+    static constexpr unsigned BLOCK_SIDE = 2;
+    static constexpr unsigned BLOCK_WINDOW_SIDE = BLOCK_SIDE + WINDOW_SIDE - 1;
+
+    explicit BlockRule(const EnhancementLookup& lookup) {
+        for(unsigned window = 0; window < NUMBER_OF_WINDOWS; ++window) {
+            unsigned char block = 0;
+            for(unsigned block_y = 0; block_y < BLOCK_SIDE; ++block_y) {
+                for(unsigned block_x = 0; block_x < BLOCK_SIDE; ++block_x) {
+                    unsigned lookup_index = 0;
+                    for(unsigned y = block_y; y < block_y + WINDOW_SIDE; ++y) {
+                        for(unsigned x = block_x; x < block_x + WINDOW_SIDE; ++x) {
+                            lookup_index = (lookup_index << 1) | ((window >> (y * BLOCK_WINDOW_SIDE + x)) & 1);
+                        }
+                    }
+                    block |= static_cast<unsigned char>(lookup[lookup_index]) << (block_y * BLOCK_SIDE + block_x);
+                }
+            }
+            blocks[window] = block;
+        }
+    }
+
+    [[nodiscard]]
+    inline unsigned operator[](unsigned window) const {
+        return blocks[window];
+    }
+
+private:
+    static constexpr unsigned NUMBER_OF_WINDOWS = 1u << (BLOCK_WINDOW_SIDE * BLOCK_WINDOW_SIDE);
+
+    std::array<unsigned char, NUMBER_OF_WINDOWS> blocks{};
+};
+
+// Rows from one above the upper row to one below the lower row of a pair of rows being enhanced.
+using BlockRowNeighbourhood = std::array<const Word*, BlockRule::BLOCK_WINDOW_SIDE>;
+
+// Mask of the bits of a word starting at column first that fall into [begin, end).
+inline Word mask_of_range(long long first, long long begin, long long end) {
+    const long long low = std::clamp(begin - first, 0LL, static_cast<long long>(WORD_SIZE));
+    const long long high = std::clamp(end - first, 0LL, static_cast<long long>(WORD_SIZE));
+    if(low >= high) {
+        return 0;
+    }
+    const Word up_to_high = high == WORD_SIZE ? ~Word{0} : (Word{1} << high) - 1;
+    const Word up_to_low = (Word{1} << low) - 1;
+    return up_to_high & ~up_to_low;
+}
+
+// Returns 64 pixels starting at column x, pixels outside [begin, end) read as out_of_bounds_value.
+inline Word load_pixels(const Word* row, unsigned words_in_row, long long x, long long begin, long long end, bool out_of_bounds_value) {
+    const Word out_of_bounds_word = out_of_bounds_value ? ~Word{0} : Word{0};
+    if(row == nullptr) {
+        return out_of_bounds_word;
+    }
+    const auto word_at = [row, words_in_row](long long index) {
+        return (index < 0 || index >= static_cast<long long>(words_in_row)) ? Word{0} : row[index];
+    };
+    const long long word_index = (x >= 0 ? x : x - (WORD_SIZE - 1)) / static_cast<long long>(WORD_SIZE);
+    const unsigned shift = static_cast<unsigned>(x - word_index * WORD_SIZE);
+    const Word pixels = shift == 0
+            ? word_at(word_index)
+            : (word_at(word_index) >> shift) | (word_at(word_index + 1) << (WORD_SIZE - shift));
+    const Word inside_mask = mask_of_range(x, begin, end);
+    return (pixels & inside_mask) | (out_of_bounds_word & ~inside_mask);
+}
+
+// Computes output pixels in [output_begin, output_end) from input pixels in [input_begin, input_end), 64 at a time.
+// Every input row is loaded one aligned word at a time, the left and right neighbours of its pixels are shifted in
+// from the adjacent words.
+inline void enhance_row(const BitSlicedRule& rule, const RowNeighbourhood& rows, unsigned words_in_row,
+                        long long input_begin, long long input_end, bool out_of_bounds_value,
+                        long long output_begin, long long output_end, Word* output) {
+    const long long first_word = output_begin / WORD_SIZE;
+    const long long last_word = (output_end + WORD_SIZE - 1) / WORD_SIZE;
+    const auto load = [&](unsigned row, long long word_index) {
+        return load_pixels(rows[row], words_in_row, word_index * WORD_SIZE, input_begin, input_end, out_of_bounds_value);
+    };
+    std::array<Word, WINDOW_SIDE> previous_words{};
+    std::array<Word, WINDOW_SIDE> current_words{};
+    for(unsigned row = 0; row < WINDOW_SIDE; ++row) {
+        previous_words[row] = load(row, first_word - 1);
+        current_words[row] = load(row, first_word);
+    }
+    for(long long word_index = first_word; word_index < last_word; ++word_index) {
+        BitSlicedRule::WindowPlanes planes{};
+        for(unsigned row = 0; row < WINDOW_SIDE; ++row) {
+            const Word next_word = load(row, word_index + 1);
+            planes[row * WINDOW_SIDE] = (current_words[row] << 1) | (previous_words[row] >> (WORD_SIZE - 1));
+            planes[row * WINDOW_SIDE + 1] = current_words[row];
+            planes[row * WINDOW_SIDE + 2] = (current_words[row] >> 1) | (next_word << (WORD_SIZE - 1));
+            previous_words[row] = current_words[row];
+            current_words[row] = next_word;
+        }
+        output[word_index] = rule(planes) & mask_of_range(word_index * WORD_SIZE, output_begin, output_end);
+    }
+}
+
+// Computes two output rows at once as enhance_row does for one, from 2x2 blocks of the memoized block rule.
+// Half a word of output takes 34 input pixels per row, which are shifted together from the aligned input words.
+// The lower output may be nullptr, then the lower row is computed but dropped.
+inline void enhance_row_pair(const BlockRule& rule, const BlockRowNeighbourhood& rows, unsigned words_in_row,
+                             long long input_begin, long long input_end, bool out_of_bounds_value,
+                             long long output_begin, long long output_end, Word* upper_output, Word* lower_output) {
+    constexpr unsigned HALF_WORD_SIZE = WORD_SIZE / 2;
+    constexpr Word NIBBLE_MASK = 0xF;
+    const long long first_word = output_begin / WORD_SIZE;
+    const long long last_word = (output_end + WORD_SIZE - 1) / WORD_SIZE;
+    const auto load = [&](unsigned row, long long word_index) {
+        return load_pixels(rows[row], words_in_row, word_index * WORD_SIZE, input_begin, input_end, out_of_bounds_value);
+    };
+    std::array<Word, BlockRule::BLOCK_WINDOW_SIDE> previous_words{};
+    std::array<Word, BlockRule::BLOCK_WINDOW_SIDE> current_words{};
+    for(unsigned row = 0; row < BlockRule::BLOCK_WINDOW_SIDE; ++row) {
+        previous_words[row] = load(row, first_word - 1);
+        current_words[row] = load(row, first_word);
+    }
+    for(long long word_index = first_word; word_index < last_word; ++word_index) {
+        // Row r of half h starts at the pixel left of the half.
+        std::array<std::array<Word, BlockRule::BLOCK_WINDOW_SIDE>, 2> half_windows{};
+        for(unsigned row = 0; row < BlockRule::BLOCK_WINDOW_SIDE; ++row) {
+            const Word next_word = load(row, word_index + 1);
+            half_windows[0][row] = (current_words[row] << 1) | (previous_words[row] >> (WORD_SIZE - 1));
+            half_windows[1][row] = (current_words[row] >> (HALF_WORD_SIZE - 1)) | (next_word << (HALF_WORD_SIZE + 1));
+            previous_words[row] = current_words[row];
+            current_words[row] = next_word;
+        }
+        Word upper_pixels = 0;
+        Word lower_pixels = 0;
+        for(unsigned half = 0; half < 2; ++half) {
+            const auto& window_rows = half_windows[half];
+            for(unsigned shift = 0; shift < HALF_WORD_SIZE; shift += BlockRule::BLOCK_SIDE) {
+                const unsigned window = static_cast<unsigned>(((window_rows[0] >> shift) & NIBBLE_MASK) |
+                                                              (((window_rows[1] >> shift) & NIBBLE_MASK) << 4) |
+                                                              (((window_rows[2] >> shift) & NIBBLE_MASK) << 8) |
+                                                              (((window_rows[3] >> shift) & NIBBLE_MASK) << 12));
+                const Word block = rule[window];
+                upper_pixels |= (block & 3) << (half * HALF_WORD_SIZE + shift);
+                lower_pixels |= (block >> 2) << (half * HALF_WORD_SIZE + shift);
+            }
+        }
+        const Word output_mask = mask_of_range(word_index * WORD_SIZE, output_begin, output_end);
+        upper_output[word_index] = upper_pixels & output_mask;
+        if(lower_output != nullptr) {
+            lower_output[word_index] = lower_pixels & output_mask;
+        }
+    }
+}
+
+}
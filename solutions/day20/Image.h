@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <bit>
+#include <numeric>
+#include <stdexcept>
+
+class Image {
+public:
+    using Word = std::uint64_t;
+    static constexpr unsigned WORD_SIZE = 64;
+
+    Image(unsigned width, unsigned height, bool default_value = false)
+            : image_width{width}, image_height{height}, words_per_row{(width + WORD_SIZE - 1) / WORD_SIZE},
+              image_data_row_major(words_per_row * height, default_value ? ~Word{0} : Word{0}) {
+        clear_padding_bits();
+    }
+
+    Image(const std::vector<bool>& image_data, unsigned width, unsigned height)
+            : Image(width, height) {
+        if(width * height != image_data.size()) {
+            throw std::runtime_error{"Image data size does not match given width and height"};
+        }
+        for(unsigned y = 0; y < height; ++y) {
+            for(unsigned x = 0; x < width; ++x) {
+                set(x, y, image_data[y * width + x]);
+            }
+        }
+    }
+
+    [[nodiscard]]
+    inline unsigned width() const {
+        return image_width;
+    }
+
+    [[nodiscard]]
+    inline unsigned height() const {
+        return image_height;
+    }
+
+    [[nodiscard]]
+    inline unsigned row_length_in_words() const {
+        return words_per_row;
+    }
+
+    [[nodiscard]]
+    inline const Word* row(unsigned y) const {
+        return image_data_row_major.data() + y * words_per_row;
+    }
+
+    [[nodiscard]]
+    inline Word* row(unsigned y) {
+        return image_data_row_major.data() + y * words_per_row;
+    }
+
+    [[nodiscard]]
+    inline bool get(unsigned x, unsigned y) const {
+        return (row(y)[x / WORD_SIZE] >> (x % WORD_SIZE)) & 1;
+    }
+
+    inline void set(unsigned x, unsigned y, bool value) {
+        Word& word = row(y)[x / WORD_SIZE];
+        const Word bit = Word{1} << (x % WORD_SIZE);
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    [[nodiscard]]
+    inline unsigned active_pixel_count() const {
+        const auto popcount_accumulator = [](unsigned previous, Word word) {
+            return previous + std::popcount(word);
+        };
+        return std::accumulate(std::begin(image_data_row_major), std::end(image_data_row_major), 0u, popcount_accumulator);
+    }
+
+    friend bool operator==(const Image&, const Image&) = default;
+
+    void clear_padding_bits() {
+        if(image_width % WORD_SIZE == 0) {
+            return;
+        }
+        const Word last_word_mask = (Word{1} << (image_width % WORD_SIZE)) - 1;
+        for(unsigned y = 0; y < image_height; ++y) {
+            row(y)[words_per_row - 1] &= last_word_mask;
+        }
+    }
+
+private:
+    unsigned image_width{};
+    unsigned image_height{};
+    unsigned words_per_row{};
+    std::vector<Word> image_data_row_major{};
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <stdexcept>
+
+#include <ThreadPool.h>
+#include <Image.h>
+#include <EnhancementKernel.h>
+
+class ImageEnhancer {
+public:
+
+    ImageEnhancer(const std::vector<bool>& algorithm, const Image& image, unsigned maximal_number_of_steps, unsigned number_of_threads = 1) :
+        thread_pool{number_of_threads > 1 ? std::make_unique<ThreadPool>(number_of_threads) : nullptr},
+        lookup{enhancement_kernel::make_lookup(algorithm)},
+        rule{lookup},
+        block_rule{lookup},
+        current_image{image.width() + 2 * maximal_number_of_steps, image.height() + 2 * maximal_number_of_steps},
+        next_image{current_image.width(), current_image.height()},
+        region_x_begin{maximal_number_of_steps},
+        region_x_end{maximal_number_of_steps + image.width()},
+        region_y_begin{maximal_number_of_steps},
+        region_y_end{maximal_number_of_steps + image.height()} {
+        for(unsigned y = 0; y < image.height(); ++y) {
+            for(unsigned x = 0; x < image.width(); ++x) {
+                current_image.set(x + region_x_begin, y + region_y_begin, image.get(x, y));
+            }
+        }
+    }
+
+    void step() {
+        if(region_x_begin == 0 || region_y_begin == 0) {
+            throw std::runtime_error{"Image enhancer can not grow the image any further"};
+        }
+        const unsigned first_row = region_y_begin - 1;
+        const unsigned number_of_rows = region_y_end + 1 - first_row;
+        for_each_row_band(number_of_rows, [this, first_row](unsigned, unsigned band_begin, unsigned band_end) {
+            enhance_rows(first_row + band_begin, first_row + band_end);
+        });
+        std::swap(current_image, next_image);
+        --region_x_begin;
+        --region_y_begin;
+        ++region_x_end;
+        ++region_y_end;
+        out_of_bounds_value = out_of_bounds_value ? lookup.back() : lookup.front();
+    }
+
+    // Advances by the given number of steps, at most steps_per_pass of them in every pass over the image. A pass runs
+    // band by band, every band goes through all steps of the pass in scratch rows of its own while they are cached,
+    // so the image is read and written once per pass instead of once per step. The rows a band needs from its
+    // neighbours grow by one per remaining step and are computed again by every band needing them. All steps use the
+    // memoized block rule, two rows at a time.
+    void fast_forward(unsigned number_of_steps, unsigned steps_per_pass) {
+        if(steps_per_pass == 0) {
+            throw std::runtime_error{"Fast forward needs at least one step per pass"};
+        }
+        while(number_of_steps != 0) {
+            const unsigned steps_in_pass = std::min(number_of_steps, steps_per_pass);
+            apply_pass(steps_in_pass);
+            number_of_steps -= steps_in_pass;
+        }
+    }
+
+    [[nodiscard]]
+    unsigned active_pixel_count() const {
+        const unsigned number_of_rows = region_y_end - region_y_begin;
+        std::vector<unsigned> active_pixels_in_bands(number_of_row_bands(number_of_rows), 0);
+        for_each_row_band(number_of_rows, [this, &active_pixels_in_bands](unsigned band_index, unsigned band_begin, unsigned band_end) {
+            active_pixels_in_bands[band_index] = count_active_pixels(region_y_begin + band_begin, region_y_begin + band_end);
+        });
+        return std::accumulate(std::begin(active_pixels_in_bands), std::end(active_pixels_in_bands), 0u);
+    }
+
+    // The whole buffer including the margin left for further steps, pixels outside the current region are clear.
+    [[nodiscard]]
+    inline const Image& get_image() const {
+        return current_image;
+    }
+
+private:
+    static constexpr unsigned ROW_BANDS_PER_THREAD = 4;
+    // Output rows per band of a fast forward pass, the scratch rows of a band of a wide image stay in the second level
+    // cache while the halo rows cost little for the usual numbers of steps per pass.
+    static constexpr unsigned FAST_FORWARD_BAND_HEIGHT = 64;
+
+    std::unique_ptr<ThreadPool> thread_pool{};
+    enhancement_kernel::EnhancementLookup lookup{};
+    enhancement_kernel::BitSlicedRule rule;
+    enhancement_kernel::BlockRule block_rule;
+    Image current_image;
+    Image next_image;
+    unsigned region_x_begin{};
+    unsigned region_x_end{};
+    unsigned region_y_begin{};
+    unsigned region_y_end{};
+    bool out_of_bounds_value = false;
+
+    void enhance_rows(unsigned first_row, unsigned last_row) {
+        for(unsigned y = first_row; y < last_row; ++y) {
+            enhancement_kernel::RowNeighbourhood rows{row_in_region(y - 1), row_in_region(y), row_in_region(y + 1)};
+            enhancement_kernel::enhance_row(rule, rows, current_image.row_length_in_words(),
+                                            region_x_begin, region_x_end, out_of_bounds_value,
+                                            region_x_begin - 1, region_x_end + 1, next_image.row(y));
+        }
+    }
+
+    void apply_pass(unsigned number_of_steps) {
+        if(region_x_begin < number_of_steps || region_y_begin < number_of_steps) {
+            throw std::runtime_error{"Image enhancer can not grow the image any further"};
+        }
+        // Value of the pixels outside the region before every step of the pass and after the last one.
+        std::vector<bool> out_of_bounds_values{out_of_bounds_value};
+        for(unsigned step = 0; step < number_of_steps; ++step) {
+            out_of_bounds_values.push_back(out_of_bounds_values.back() ? lookup.back() : lookup.front());
+        }
+        const unsigned first_row = region_y_begin - number_of_steps;
+        const unsigned number_of_rows = region_y_end + number_of_steps - first_row;
+        const unsigned number_of_bands = (number_of_rows + FAST_FORWARD_BAND_HEIGHT - 1) / FAST_FORWARD_BAND_HEIGHT;
+        const auto band_task = [&](unsigned band_index) {
+            const unsigned band_begin = first_row + band_index * FAST_FORWARD_BAND_HEIGHT;
+            const unsigned band_end = first_row + std::min((band_index + 1) * FAST_FORWARD_BAND_HEIGHT, number_of_rows);
+            enhance_band_over_pass(number_of_steps, out_of_bounds_values, band_begin, band_end);
+        };
+        if(thread_pool) {
+            thread_pool->run_and_wait(number_of_bands, band_task);
+        }
+        else {
+            for(unsigned band_index = 0; band_index < number_of_bands; ++band_index) {
+                band_task(band_index);
+            }
+        }
+        std::swap(current_image, next_image);
+        region_x_begin -= number_of_steps;
+        region_y_begin -= number_of_steps;
+        region_x_end += number_of_steps;
+        region_y_end += number_of_steps;
+        out_of_bounds_value = out_of_bounds_values.back();
+    }
+
+    // Computes the rows [band_begin, band_end) of the image after all steps of a pass into the next image. Step s
+    // computes the rows of the band and the (number_of_steps - s) rows around it which lie in its region, into one
+    // of two scratch buffers whose row i is image row band_begin - number_of_steps + i.
+    void enhance_band_over_pass(unsigned number_of_steps, const std::vector<bool>& out_of_bounds_values, unsigned band_begin, unsigned band_end) {
+        const unsigned words_in_row = current_image.row_length_in_words();
+        const long long scratch_first_row = static_cast<long long>(band_begin) - number_of_steps;
+        const std::size_t scratch_size = static_cast<std::size_t>(band_end - band_begin + 2 * number_of_steps) * words_in_row;
+        std::array<std::vector<Image::Word>, 2> scratch{std::vector<Image::Word>(scratch_size), std::vector<Image::Word>(scratch_size)};
+        for(unsigned step = 1; step <= number_of_steps; ++step) {
+            // Region of the input of this step.
+            const long long input_x_begin = region_x_begin - (step - 1LL);
+            const long long input_x_end = region_x_end + (step - 1LL);
+            const long long input_y_begin = region_y_begin - (step - 1LL);
+            const long long input_y_end = region_y_end + (step - 1LL);
+            const long long halo = number_of_steps - step;
+            const long long first_row = std::max(band_begin - halo, input_y_begin - 1);
+            const long long last_row = std::min(band_end + halo, input_y_end + 1);
+            const auto input_row = [&](long long y) -> const Image::Word* {
+                if(y < input_y_begin || y >= input_y_end) {
+                    return nullptr;
+                }
+                if(step == 1) {
+                    return current_image.row(static_cast<unsigned>(y));
+                }
+                return scratch[(step - 1) % 2].data() + static_cast<std::size_t>(y - scratch_first_row) * words_in_row;
+            };
+            const auto output_row = [&](long long y) -> Image::Word* {
+                if(y >= last_row) {
+                    return nullptr;
+                }
+                if(step == number_of_steps) {
+                    return next_image.row(static_cast<unsigned>(y));
+                }
+                return scratch[step % 2].data() + static_cast<std::size_t>(y - scratch_first_row) * words_in_row;
+            };
+            for(long long y = first_row; y < last_row; y += enhancement_kernel::BlockRule::BLOCK_SIDE) {
+                const enhancement_kernel::BlockRowNeighbourhood rows{input_row(y - 1), input_row(y), input_row(y + 1), input_row(y + 2)};
+                enhancement_kernel::enhance_row_pair(block_rule, rows, words_in_row,
+                                                     input_x_begin, input_x_end, out_of_bounds_values[step - 1],
+                                                     input_x_begin - 1, input_x_end + 1, output_row(y), output_row(y + 1));
+            }
+        }
+    }
+
+    [[nodiscard]]
+    unsigned count_active_pixels(unsigned first_row, unsigned last_row) const {
+        unsigned active_pixels = 0;
+        const unsigned first_word = region_x_begin / Image::WORD_SIZE;
+        const unsigned last_word = (region_x_end + Image::WORD_SIZE - 1) / Image::WORD_SIZE;
+        for(unsigned y = first_row; y < last_row; ++y) {
+            const auto* row = current_image.row(y);
+            for(unsigned word_index = first_word; word_index < last_word; ++word_index) {
+                const auto mask = enhancement_kernel::mask_of_range(word_index * Image::WORD_SIZE, region_x_begin, region_x_end);
+                active_pixels += std::popcount(row[word_index] & mask);
+            }
+        }
+        return active_pixels;
+    }
+
+    [[nodiscard]]
+    inline unsigned number_of_row_bands(unsigned number_of_rows) const {
+        const unsigned band_height = row_band_height(number_of_rows);
+        return (number_of_rows + band_height - 1) / band_height;
+    }
+
+    [[nodiscard]]
+    inline unsigned row_band_height(unsigned number_of_rows) const {
+        const unsigned number_of_threads = thread_pool ? thread_pool->size() : 1;
+        const unsigned wanted_number_of_bands = number_of_threads * ROW_BANDS_PER_THREAD;
+        return std::max((number_of_rows + wanted_number_of_bands - 1) / wanted_number_of_bands, 1u);
+    }
+
+    // Calls band_function(band_index, band_begin, band_end) for consecutive bands of rows, on the thread pool if there is one.
+    template<typename BandFunction>
+    void for_each_row_band(unsigned number_of_rows, const BandFunction& band_function) const {
+        const unsigned band_height = row_band_height(number_of_rows);
+        const auto band_task = [number_of_rows, band_height, &band_function](unsigned band_index) {
+            band_function(band_index, band_index * band_height, std::min((band_index + 1) * band_height, number_of_rows));
+        };
+        if(thread_pool) {
+            thread_pool->run_and_wait(number_of_row_bands(number_of_rows), band_task);
+            return;
+        }
+        for(unsigned band_index = 0; band_index < number_of_row_bands(number_of_rows); ++band_index) {
+            band_task(band_index);
+        }
+    }
+
+    [[nodiscard]]
+    inline const Image::Word* row_in_region(unsigned y) const {
+        return (y >= region_y_begin && y < region_y_end) ? current_image.row(y) : nullptr;
+    }
+};
@@ -1,79 +1,12 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <optional>
+#include <algorithm>
 #include <Utils.h>
-
-class Image {
-public:
-
-    Image(std::vector<bool> image_data, unsigned width, unsigned height)
-            : image_data_row_major{std::move(image_data)}, image_width{width}, image_height{height} {
-        if(width * height != image_data_row_major.size()) {
-            throw std::runtime_error{"Image data size does not match given width and height"};
-        }
-    }
-
-    [[nodiscard]]
-    inline unsigned width() const {
-        return image_width;
-    }
-
-    [[nodiscard]]
-    inline unsigned height() const {
-        return image_height;
-    }
-
-    inline void set(unsigned x, unsigned y, bool value) {
-        image_data_row_major.at(y * image_width + x) = value;
-    }
-
-    [[nodiscard]]
-    unsigned get_neighbours_value(unsigned x, unsigned y, bool out_of_bounds_value = false) const {
-        unsigned neighbours_value = 0;
-        unsigned position = 8;
-        for(int y_mod = -1; y_mod <= 1; ++y_mod) {
-            for(int x_mod = -1; x_mod <= 1; ++x_mod) {
-                int x_neighbour = static_cast<int>(x) + x_mod;
-                int y_neighbour = static_cast<int>(y) + y_mod;
-                bool value = is_out_of_bounds(x_neighbour, y_neighbour)
-                        ? out_of_bounds_value
-                        : image_data_row_major.at(y_neighbour * image_width + x_neighbour);
-                neighbours_value |= (static_cast<unsigned>(value) << position);
-                --position;
-            }
-        }
-        return neighbours_value;
-    }
-
-    [[nodiscard]]
-    inline unsigned active_pixel_count() const {
-        return std::count(std::begin(image_data_row_major), std::end(image_data_row_major), true);
-    }
-
-    void enlarge(unsigned width_enlargement, unsigned height_enlargement, bool default_value = false) {
-        unsigned new_width = image_width + width_enlargement * 2;
-        unsigned new_height = image_height + height_enlargement * 2;
-        std::vector<bool> new_image_data(new_height * new_width, default_value);
-        for(unsigned y = 0; y < image_height; ++y) {
-            for(unsigned x = 0; x < image_width; ++x) {
-                new_image_data.at((y + height_enlargement) * new_width + x + width_enlargement) = image_data_row_major.at(y * image_width + x);
-            }
-        }
-        image_data_row_major = new_image_data;
-        image_width = new_width;
-        image_height = new_height;
-    }
-
-private:
-    std::vector<bool> image_data_row_major{};
-    unsigned image_width{};
-    unsigned image_height{};
-
-    [[nodiscard]]
-    inline bool is_out_of_bounds(int x, int y) const {
-        return (x < 0 || x > static_cast<int>(image_width) - 1 || y < 0 || y > static_cast<int>(image_height) - 1);
-    }
-};
+#include <Benchmark.h>
+#include <Image.h>
+#include <ImageEnhancer.h>
 
 using ImageEnhancementAlgorithm = std::vector<bool>;
 
@@ -118,33 +51,90 @@ std::pair<ImageEnhancementAlgorithm, Image> read_puzzle_input(const std::string&
     return { image_enhancement_algorithm, image };
 }
 
-Image enhance_image(const ImageEnhancementAlgorithm& algorithm, const Image& image, bool out_of_bounds_value) {
-    Image new_image = image;
-    for(unsigned y = 0; y < image.height(); ++y) {
-        for(unsigned x = 0; x < image.width(); ++x) {
-            unsigned new_value_index = image.get_neighbours_value(x, y, out_of_bounds_value);
-            bool new_value = algorithm.at(new_value_index);
-            new_image.set(x, y, new_value);
+unsigned enhance_image_and_count_lit_pixels(const ImageEnhancementAlgorithm& algorithm, const Image& image, unsigned number_of_steps) {
+    ImageEnhancer enhancer{algorithm, image, number_of_steps, std::thread::hardware_concurrency()};
+    for(unsigned step = 0; step < number_of_steps; ++step) {
+        enhancer.step();
+    }
+    return enhancer.active_pixel_count();
+}
+
+Image tile_image(const Image& image, unsigned number_of_tiles) {
+    Image tiled_image{image.width() * number_of_tiles, image.height() * number_of_tiles};
+    for(unsigned y = 0; y < tiled_image.height(); ++y) {
+        for(unsigned x = 0; x < tiled_image.width(); ++x) {
+            tiled_image.set(x, y, image.get(x % image.width(), y % image.height()));
         }
     }
-    return new_image;
+    return tiled_image;
 }
 
-unsigned enhance_image_and_count_lit_pixels(const ImageEnhancementAlgorithm& algorithm, Image image, unsigned number_of_steps) {
-    image.enlarge(number_of_steps, number_of_steps);
-    bool out_of_bounds_value = false;
-    bool all_neighbours_off_value = algorithm.front();
-    bool all_neighbours_on_value = algorithm.back();
-    for(unsigned step = 0; step < number_of_steps; ++step) {
-        image = enhance_image(algorithm, image, out_of_bounds_value);
-        out_of_bounds_value = out_of_bounds_value ? all_neighbours_on_value : all_neighbours_off_value;
+// Every thread count has to produce the same image as a single thread, the part answers rely on that.
+void report_enhancement_time(const ImageEnhancementAlgorithm& algorithm, const Image& image) {
+    constexpr unsigned NUMBER_OF_STEPS = 50;
+    const auto tiled_image = tile_image(image, 10);
+    std::vector<unsigned> thread_counts{1, 2, 4, std::thread::hardware_concurrency()};
+    std::sort(std::begin(thread_counts), std::end(thread_counts));
+    thread_counts.erase(std::unique(std::begin(thread_counts), std::end(thread_counts)), std::end(thread_counts));
+    std::optional<Image> expected_image{};
+    unsigned expected_active_pixels = 0;
+    double single_thread_time = 0.0;
+    for(const unsigned number_of_threads: thread_counts) {
+        if(number_of_threads == 0) {
+            continue;
+        }
+        ImageEnhancer enhancer{algorithm, tiled_image, NUMBER_OF_STEPS, number_of_threads};
+        double time = benchmark::measure_milliseconds([&]() {
+            for(unsigned step = 0; step < NUMBER_OF_STEPS; ++step) {
+                enhancer.step();
+            }
+        });
+        const unsigned active_pixels = enhancer.active_pixel_count();
+        if(!expected_image) {
+            expected_image = enhancer.get_image();
+            expected_active_pixels = active_pixels;
+            single_thread_time = time;
+        }
+        else if(active_pixels != expected_active_pixels || enhancer.get_image() != *expected_image) {
+            throw std::runtime_error{"Parallel result differs from the serial one"};
+        }
+        std::cout << NUMBER_OF_STEPS << " steps of a " << tiled_image.width() << "x" << tiled_image.height() << " image, threads: "
+                  << number_of_threads << ", time: " << time << " ms, speedup: " << single_thread_time / time << ", "
+                  << active_pixels << " lit pixels" << std::endl;
+    }
+}
+
+// The block rule fast forward against single steps of the bit-sliced rule, which it has to match exactly.
+void report_fast_forward(const ImageEnhancementAlgorithm& algorithm, const Image& image) {
+    constexpr unsigned NUMBER_OF_STEPS = 50;
+    for(const unsigned number_of_tiles: {10u, 40u}) {
+        const auto tiled_image = tile_image(image, number_of_tiles);
+        ImageEnhancer stepped_enhancer{algorithm, tiled_image, NUMBER_OF_STEPS};
+        double step_time = benchmark::measure_milliseconds([&]() {
+            for(unsigned step = 0; step < NUMBER_OF_STEPS; ++step) {
+                stepped_enhancer.step();
+            }
+        });
+        std::cout << NUMBER_OF_STEPS << " single steps of a " << tiled_image.width() << "x" << tiled_image.height() << " image: "
+                  << step_time << " ms, " << stepped_enhancer.active_pixel_count() << " lit pixels" << std::endl;
+        for(const unsigned steps_per_pass: {1u, 2u, 5u, 10u, 25u}) {
+            ImageEnhancer enhancer{algorithm, tiled_image, NUMBER_OF_STEPS};
+            double time = benchmark::measure_milliseconds([&]() { enhancer.fast_forward(NUMBER_OF_STEPS, steps_per_pass); });
+            if(enhancer.active_pixel_count() != stepped_enhancer.active_pixel_count() || enhancer.get_image() != stepped_enhancer.get_image()) {
+                throw std::runtime_error{"Fast forward result differs from the single step one"};
+            }
+            std::cout << "Fast forward with " << steps_per_pass << " steps per pass: " << time << " ms, speedup: " << step_time / time << std::endl;
+        }
     }
-    return image.active_pixel_count();
 }
 
-int main() {
+int main(int argc, char** argv) {
     const auto[image_enhancement_algorithm, infinite_image] = read_puzzle_input("input.txt");
     std::cout << "Part 1: " << enhance_image_and_count_lit_pixels(image_enhancement_algorithm, infinite_image, 2) << std::endl;
     std::cout << "Part 2: " << enhance_image_and_count_lit_pixels(image_enhancement_algorithm, infinite_image, 50) << std::endl;
+    if(benchmark::is_requested(argc, argv)) {
+        report_enhancement_time(image_enhancement_algorithm, infinite_image);
+        report_fast_forward(image_enhancement_algorithm, infinite_image);
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <stdexcept>
+
+#include <CheckedArithmetic.h>
+
+// Plays Dirac dice with the deterministic die up to any winning score without simulating every turn.
+// A round is a turn of both players. Positions and the next die value at the start of a round fully determine all
+// later rounds, so the rounds are played only until such a state repeats. From then on, every period of rounds adds
+// the same points to both scores, and the round in which a score reaches the winning score is computed directly.
+class DeterministicDiceGame {
+public:
+    using Score = unsigned long long;
+
+    explicit DeterministicDiceGame(unsigned first_player_position, unsigned second_player_position,
+                                   unsigned board_size = 10, unsigned die_sides = 100) :
+        board_size{board_size},
+        die_sides{die_sides} {
+        if(board_size == 0 || die_sides == 0) {
+            throw std::runtime_error{"Board size and die sides have to be positive"};
+        }
+        if(first_player_position < 1 || first_player_position > board_size || second_player_position < 1 || second_player_position > board_size) {
+            throw std::runtime_error{"Starting position is not on the board"};
+        }
+        play_until_state_repeats(first_player_position - 1, second_player_position - 1);
+    }
+
+    // Score of the losing player multiplied by the number of die rolls when the game ends.
+    [[nodiscard]]
+    Score play(Score winning_score) const {
+        if(winning_score == 0) {
+            throw std::runtime_error{"Winning score has to be positive"};
+        }
+        for(std::size_t round = 0; round < first_round_of_period; ++round) {
+            if(first_player_scores[round + 1] >= winning_score) {
+                return result(2 * round, second_player_scores[round]);
+            }
+            if(second_player_scores[round + 1] >= winning_score) {
+                return result(2 * round + 1, first_player_scores[round + 1]);
+            }
+        }
+        const std::size_t rounds_in_period = second_player_scores.size() - 1 - first_round_of_period;
+        const Score first_player_gain = first_player_scores.back() - first_player_scores[first_round_of_period];
+        const Score second_player_gain = second_player_scores.back() - second_player_scores[first_round_of_period];
+        Score ending_turn = std::numeric_limits<Score>::max();
+        Score loser_score = 0;
+        for(std::size_t round = first_round_of_period; round < first_round_of_period + rounds_in_period; ++round) {
+            const Score first_player_periods = periods_needed(first_player_scores[round + 1], first_player_gain, winning_score);
+            const Score first_player_turn = 2 * (round + first_player_periods * rounds_in_period);
+            if(first_player_turn < ending_turn) {
+                ending_turn = first_player_turn;
+                loser_score = second_player_scores[round] + first_player_periods * second_player_gain;
+            }
+            const Score second_player_periods = periods_needed(second_player_scores[round + 1], second_player_gain, winning_score);
+            const Score second_player_turn = 2 * (round + second_player_periods * rounds_in_period) + 1;
+            if(second_player_turn < ending_turn) {
+                ending_turn = second_player_turn;
+                loser_score = first_player_scores[round + 1] + second_player_periods * first_player_gain;
+            }
+        }
+        return result(ending_turn, loser_score);
+    }
+
+    [[nodiscard]]
+    inline std::size_t get_rounds_in_period() const {
+        return second_player_scores.size() - 1 - first_round_of_period;
+    }
+
+private:
+    static constexpr unsigned ROLLS_PER_TURN = 3;
+    static constexpr unsigned NOT_SEEN = std::numeric_limits<unsigned>::max();
+
+    unsigned board_size{};
+    unsigned die_sides{};
+    // Scores after the given number of rounds, up to and including the round which repeats an earlier state.
+    std::vector<Score> first_player_scores{};
+    std::vector<Score> second_player_scores{};
+    std::size_t first_round_of_period{};
+
+    // Die values run from 1 to die_sides, die_state is the next value minus one.
+    [[nodiscard]]
+    inline unsigned roll_three_times(unsigned& die_state) const {
+        unsigned sum = 0;
+        for(unsigned roll = 0; roll < ROLLS_PER_TURN; ++roll) {
+            sum += die_state + 1;
+            die_state = die_state + 1 == die_sides ? 0 : die_state + 1;
+        }
+        return sum;
+    }
+
+    [[nodiscard]]
+    inline unsigned take_turn(unsigned position, unsigned& die_state) const {
+        return (position + roll_three_times(die_state)) % board_size;
+    }
+
+    void play_until_state_repeats(unsigned first_player_position, unsigned second_player_position) {
+        std::vector<unsigned> round_by_state(static_cast<std::size_t>(board_size) * board_size * die_sides, NOT_SEEN);
+        unsigned die_state = 0;
+        first_player_scores.emplace_back(0);
+        second_player_scores.emplace_back(0);
+        for(unsigned round = 0; ; ++round) {
+            const std::size_t state = (static_cast<std::size_t>(first_player_position) * board_size + second_player_position) * die_sides + die_state;
+            if(round_by_state[state] != NOT_SEEN) {
+                first_round_of_period = round_by_state[state];
+                return;
+            }
+            round_by_state[state] = round;
+            first_player_position = take_turn(first_player_position, die_state);
+            second_player_position = take_turn(second_player_position, die_state);
+            first_player_scores.emplace_back(first_player_scores.back() + first_player_position + 1);
+            second_player_scores.emplace_back(second_player_scores.back() + second_player_position + 1);
+        }
+    }
+
+    // Number of whole periods after which a score which grows by gain per period reaches the winning score.
+    [[nodiscard]]
+    static inline Score periods_needed(Score score, Score gain, Score winning_score) {
+        return score >= winning_score ? 0 : (winning_score - score - 1) / gain + 1;
+    }
+
+    [[nodiscard]]
+    static Score result(Score ending_turn, Score loser_score) {
+        Score number_of_rolls = 0;
+        Score product = 0;
+        if(checked_arithmetic::multiply_overflows(ending_turn + 1, Score{ROLLS_PER_TURN}, number_of_rolls) ||
+           checked_arithmetic::multiply_overflows(number_of_rolls, loser_score, product)) {
+            throw std::overflow_error{"Result of the game does not fit into 64 bits"};
+        }
+        return product;
+    }
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <UniverseCount.h>
+
+// Counts the universes won by each player of Dirac dice on a board of any size and for any winning score.
+// Unfinished games are kept in a dense array indexed by both positions and scores, one array per turn, the two arrays
+// are swapped after every turn. A turn adds the games of a state to the seven sums of three rolls of a 3-sided die.
+class DiracDiceEngine {
+public:
+    using Count = universe_count::Count;
+    using Wins = std::array<Count, 2>;
+
+    explicit DiracDiceEngine(unsigned board_size = 10, unsigned winning_score = 21) :
+        board_size{board_size},
+        winning_score{winning_score},
+        unfinished_games(static_cast<std::size_t>(board_size) * winning_score * board_size * winning_score, 0),
+        next_unfinished_games(unfinished_games.size(), 0) {
+        if(board_size == 0 || winning_score == 0) {
+            throw std::runtime_error{"Board size and winning score have to be positive"};
+        }
+    }
+
+    [[nodiscard]]
+    Wins count_wins(unsigned first_player_position, unsigned second_player_position) {
+        if(first_player_position < 1 || first_player_position > board_size || second_player_position < 1 || second_player_position > board_size) {
+            throw std::runtime_error{"Starting position is not on the board"};
+        }
+        std::fill(std::begin(unfinished_games), std::end(unfinished_games), 0);
+        unfinished_games[index(first_player_position - 1, 0, second_player_position - 1, 0)] = 1;
+        Wins wins{0, 0};
+        has_unfinished_games = true;
+        for(unsigned turn = 0; has_unfinished_games; ++turn) {
+            std::fill(std::begin(next_unfinished_games), std::end(next_unfinished_games), 0);
+            has_unfinished_games = false;
+            if(turn % 2 == 0) {
+                wins[0] = universe_count::add(wins[0], first_player_turn(turn / 2));
+            }
+            else {
+                wins[1] = universe_count::add(wins[1], second_player_turn(turn / 2));
+            }
+            std::swap(unfinished_games, next_unfinished_games);
+        }
+        return wins;
+    }
+
+private:
+    // Sums of three rolls of a 3-sided die with the number of ways to roll them.
+    static constexpr std::array<std::pair<unsigned, Count>, 7> ROLL_SUMS{{{3, 1}, {4, 3}, {5, 6}, {6, 7}, {7, 6}, {8, 3}, {9, 1}}};
+
+    unsigned board_size{};
+    unsigned winning_score{};
+    std::vector<Count> unfinished_games{};
+    std::vector<Count> next_unfinished_games{};
+    bool has_unfinished_games = false;
+
+    [[nodiscard]]
+    inline std::size_t index(unsigned first_position, unsigned first_score, unsigned second_position, unsigned second_score) const {
+        return ((static_cast<std::size_t>(first_position) * winning_score + first_score) * board_size + second_position) * winning_score + second_score;
+    }
+
+    [[nodiscard]]
+    inline std::size_t second_player_block_size() const {
+        return static_cast<std::size_t>(board_size) * winning_score;
+    }
+
+    // A player who took turns_taken turns already has a score of at least turns_taken, lower scores are never occupied.
+    [[nodiscard]]
+    inline unsigned lowest_possible_score(unsigned turns_taken) const {
+        return std::min(turns_taken, winning_score);
+    }
+
+    // All states with the same first player position and score form a contiguous block, which moves as a whole.
+    Count first_player_turn(unsigned turns_taken) {
+        Count wins = 0;
+        const std::size_t block_size = second_player_block_size();
+        for(unsigned position = 0; position < board_size; ++position) {
+            for(unsigned score = lowest_possible_score(turns_taken); score < winning_score; ++score) {
+                const Count* block = unfinished_games.data() + index(position, score, 0, 0);
+                Count games_in_block = 0;
+                for(std::size_t state = 0; state < block_size; ++state) {
+                    games_in_block = universe_count::add(games_in_block, block[state]);
+                }
+                if(games_in_block == 0) {
+                    continue;
+                }
+                for(const auto& [roll_sum, number_of_ways]: ROLL_SUMS) {
+                    const unsigned new_position = (position + roll_sum) % board_size;
+                    const unsigned new_score = score + new_position + 1;
+                    if(new_score >= winning_score) {
+                        wins = universe_count::add(wins, universe_count::multiply(games_in_block, number_of_ways));
+                        continue;
+                    }
+                    Count* new_block = next_unfinished_games.data() + index(new_position, new_score, 0, 0);
+                    for(std::size_t state = 0; state < block_size; ++state) {
+                        new_block[state] = universe_count::add(new_block[state], universe_count::multiply(block[state], number_of_ways));
+                    }
+                    has_unfinished_games = true;
+                }
+            }
+        }
+        return wins;
+    }
+
+    Count second_player_turn(unsigned turns_taken) {
+        Count wins = 0;
+        for(unsigned first_position = 0; first_position < board_size; ++first_position) {
+            for(unsigned first_score = lowest_possible_score(turns_taken + 1); first_score < winning_score; ++first_score) {
+                for(unsigned position = 0; position < board_size; ++position) {
+                    for(unsigned score = lowest_possible_score(turns_taken); score < winning_score; ++score) {
+                        const Count games = unfinished_games[index(first_position, first_score, position, score)];
+                        if(games == 0) {
+                            continue;
+                        }
+                        for(const auto& [roll_sum, number_of_ways]: ROLL_SUMS) {
+                            const unsigned new_position = (position + roll_sum) % board_size;
+                            const unsigned new_score = score + new_position + 1;
+                            if(new_score >= winning_score) {
+                                wins = universe_count::add(wins, universe_count::multiply(games, number_of_ways));
+                                continue;
+                            }
+                            Count& new_games = next_unfinished_games[index(first_position, first_score, new_position, new_score)];
+                            new_games = universe_count::add(new_games, universe_count::multiply(games, number_of_ways));
+                            has_unfinished_games = true;
+                        }
+                    }
+                }
+            }
+        }
+        return wins;
+    }
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <UniverseCount.h>
+#include <CheckedArithmetic.h>
+
+// Wins of both players from every state of Dirac dice, for any board size, winning score and number of die sides.
+// A state is the position and score of the player about to move followed by those of the other player.
+// Moving always raises a score, so states are filled by decreasing sum of scores and every state only looks up
+// states filled before it. Once built, the table answers every pair of starting positions by a lookup.
+class DiracDiceTable {
+public:
+    using Count = universe_count::Count;
+    using Wins = std::array<Count, 2>;
+
+    explicit DiracDiceTable(unsigned board_size = 10, unsigned winning_score = 21, unsigned die_sides = 3) :
+        board_size{board_size},
+        winning_score{winning_score},
+        die_sides{die_sides} {
+        if(board_size == 0 || winning_score == 0 || die_sides == 0) {
+            throw std::runtime_error{"Board size, winning score and die sides have to be positive"};
+        }
+        wins_by_state.resize(number_of_states(), Wins{0, 0});
+        fill_table();
+    }
+
+    // Wins of the first and second player when the first player moves first.
+    [[nodiscard]]
+    Wins wins(unsigned first_player_position, unsigned second_player_position) const {
+        if(first_player_position < 1 || first_player_position > board_size || second_player_position < 1 || second_player_position > board_size) {
+            throw std::runtime_error{"Starting position is not on the board"};
+        }
+        return wins_by_state[index(first_player_position - 1, 0, second_player_position - 1, 0)];
+    }
+
+    // The blob is a header with the rules followed by both win counts of every state, all little-endian.
+    void save(std::ostream& stream) const {
+        stream.write(BLOB_MAGIC.data(), BLOB_MAGIC.size());
+        for(const unsigned rule: {board_size, winning_score, die_sides}) {
+            write_little_endian(stream, rule, sizeof(std::uint32_t));
+        }
+        for(const auto& state_wins: wins_by_state) {
+            write_little_endian(stream, state_wins[0], sizeof(Count));
+            write_little_endian(stream, state_wins[1], sizeof(Count));
+        }
+        if(!stream) {
+            throw std::runtime_error{"Could not write Dirac dice table"};
+        }
+    }
+
+    static DiracDiceTable load(std::istream& stream) {
+        std::array<char, 4> magic{};
+        stream.read(magic.data(), magic.size());
+        if(!stream || magic != BLOB_MAGIC) {
+            throw std::runtime_error{"Stream does not hold a Dirac dice table"};
+        }
+        DiracDiceTable table{EmptyTable{}};
+        table.board_size = static_cast<unsigned>(read_little_endian(stream, sizeof(std::uint32_t)));
+        table.winning_score = static_cast<unsigned>(read_little_endian(stream, sizeof(std::uint32_t)));
+        table.die_sides = static_cast<unsigned>(read_little_endian(stream, sizeof(std::uint32_t)));
+        if(table.board_size == 0 || table.winning_score == 0 || table.die_sides == 0) {
+            throw std::runtime_error{"Dirac dice table has invalid rules"};
+        }
+        const std::size_t number_of_states = table.number_of_states();
+        if(count_remaining_bytes(stream) < number_of_states * BYTES_PER_STATE) {
+            throw std::runtime_error{"Dirac dice table ended too early"};
+        }
+        table.wins_by_state.resize(number_of_states);
+        for(auto& state_wins: table.wins_by_state) {
+            state_wins[0] = read_little_endian(stream, sizeof(Count));
+            state_wins[1] = read_little_endian(stream, sizeof(Count));
+        }
+        return table;
+    }
+
+    [[nodiscard]]
+    inline unsigned get_board_size() const {
+        return board_size;
+    }
+
+    [[nodiscard]]
+    inline unsigned get_winning_score() const {
+        return winning_score;
+    }
+
+    [[nodiscard]]
+    inline unsigned get_die_sides() const {
+        return die_sides;
+    }
+
+private:
+    static constexpr std::array<char, 4> BLOB_MAGIC{'D', 'D', 'T', '1'};
+    static constexpr unsigned ROLLS_PER_TURN = 3;
+    // Tables are at most 256 MiB, larger rules are rejected before anything is allocated.
+    static constexpr std::uint64_t MAXIMAL_NUMBER_OF_STATES = std::uint64_t{1} << 24;
+    static constexpr std::uint64_t BYTES_PER_STATE = 2 * sizeof(Count);
+
+    unsigned board_size{};
+    unsigned winning_score{};
+    unsigned die_sides{};
+    std::vector<Wins> wins_by_state{};
+
+    struct EmptyTable {};
+
+    explicit DiracDiceTable(EmptyTable) {}
+
+    [[nodiscard]]
+    std::size_t number_of_states() const {
+        std::uint64_t states_per_player = 0;
+        std::uint64_t number_of_states = 0;
+        if(checked_arithmetic::multiply_overflows(std::uint64_t{board_size}, std::uint64_t{winning_score}, states_per_player) ||
+           checked_arithmetic::multiply_overflows(states_per_player, states_per_player, number_of_states) ||
+           number_of_states > MAXIMAL_NUMBER_OF_STATES) {
+            throw std::runtime_error{"Dirac dice table would have too many states"};
+        }
+        return static_cast<std::size_t>(number_of_states);
+    }
+
+    [[nodiscard]]
+    inline std::size_t index(unsigned mover_position, unsigned mover_score, unsigned other_position, unsigned other_score) const {
+        return ((static_cast<std::size_t>(mover_position) * winning_score + mover_score) * board_size + other_position) * winning_score + other_score;
+    }
+
+    // Sums of the rolls of one turn with the number of ways to roll them.
+    [[nodiscard]]
+    std::vector<std::pair<unsigned, Count>> roll_sums() const {
+        std::vector<Count> ways_by_sum{1};
+        for(unsigned roll = 0; roll < ROLLS_PER_TURN; ++roll) {
+            std::vector<Count> next_ways_by_sum(ways_by_sum.size() + die_sides, 0);
+            for(unsigned sum = 0; sum < ways_by_sum.size(); ++sum) {
+                for(unsigned side = 1; side <= die_sides; ++side) {
+                    next_ways_by_sum[sum + side] += ways_by_sum[sum];
+                }
+            }
+            ways_by_sum = std::move(next_ways_by_sum);
+        }
+        std::vector<std::pair<unsigned, Count>> sums{};
+        for(unsigned sum = 0; sum < ways_by_sum.size(); ++sum) {
+            if(ways_by_sum[sum] != 0) {
+                sums.emplace_back(sum, ways_by_sum[sum]);
+            }
+        }
+        return sums;
+    }
+
+    void fill_table() {
+        const auto sums = roll_sums();
+        const unsigned highest_score = winning_score - 1;
+        for(unsigned score_sum = 2 * highest_score + 1; score_sum-- > 0; ) {
+            const unsigned lowest_mover_score = score_sum > highest_score ? score_sum - highest_score : 0;
+            for(unsigned mover_score = lowest_mover_score; mover_score <= std::min(score_sum, highest_score); ++mover_score) {
+                const unsigned other_score = score_sum - mover_score;
+                for(unsigned mover_position = 0; mover_position < board_size; ++mover_position) {
+                    for(unsigned other_position = 0; other_position < board_size; ++other_position) {
+                        wins_by_state[index(mover_position, mover_score, other_position, other_score)] =
+                            compute_wins(sums, mover_position, mover_score, other_position, other_score);
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]]
+    Wins compute_wins(const std::vector<std::pair<unsigned, Count>>& sums, unsigned mover_position, unsigned mover_score,
+                      unsigned other_position, unsigned other_score) const {
+        Wins wins{0, 0};
+        for(const auto& [roll_sum, number_of_ways]: sums) {
+            const unsigned new_position = (mover_position + roll_sum) % board_size;
+            const unsigned new_score = mover_score + new_position + 1;
+            if(new_score >= winning_score) {
+                wins[0] = universe_count::add(wins[0], number_of_ways);
+                continue;
+            }
+            const auto& next_wins = wins_by_state[index(other_position, other_score, new_position, new_score)];
+            wins[0] = universe_count::add(wins[0], universe_count::multiply(number_of_ways, next_wins[1]));
+            wins[1] = universe_count::add(wins[1], universe_count::multiply(number_of_ways, next_wins[0]));
+        }
+        return wins;
+    }
+
+    static void write_little_endian(std::ostream& stream, std::uint64_t value, unsigned number_of_bytes) {
+        for(unsigned byte = 0; byte < number_of_bytes; ++byte) {
+            stream.put(static_cast<char>((value >> (8 * byte)) & 0xFF));
+        }
+    }
+
+    // Streams which can not seek report the largest size, they are then checked while their states are read.
+    static std::uint64_t count_remaining_bytes(std::istream& stream) {
+        const auto position = stream.tellg();
+        if(position == std::istream::pos_type(-1)) {
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+        stream.seekg(0, std::ios::end);
+        const auto end = stream.tellg();
+        stream.clear();
+        stream.seekg(position);
+        if(end == std::istream::pos_type(-1)) {
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+        return static_cast<std::uint64_t>(end - position);
+    }
+
+    static std::uint64_t read_little_endian(std::istream& stream, unsigned number_of_bytes) {
+        std::uint64_t value = 0;
+        for(unsigned byte = 0; byte < number_of_bytes; ++byte) {
+            const auto character = stream.get();
+            if(character == std::istream::traits_type::eof()) {
+                throw std::runtime_error{"Dirac dice table ended too early"};
+            }
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(character)) << (8 * byte);
+        }
+        return value;
+    }
+};
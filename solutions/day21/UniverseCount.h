@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdexcept>
+
+#include <CheckedArithmetic.h>
+
+// Numbers of universes grow exponentially with the winning score, every operation throws instead of wrapping around.
+namespace universe_count {
+
+    using Count = unsigned long long;
+
+    inline Count add(Count lhs, Count rhs) {
+        Count sum = 0;
+        if(checked_arithmetic::add_overflows(lhs, rhs, sum)) {
+            throw std::overflow_error{"Number of universes does not fit into 64 bits"};
+        }
+        return sum;
+    }
+
+    inline Count multiply(Count lhs, Count rhs) {
+        Count product = 0;
+        if(checked_arithmetic::multiply_overflows(lhs, rhs, product)) {
+            throw std::overflow_error{"Number of universes does not fit into 64 bits"};
+        }
+        return product;
+    }
+
+}
@@ -1,7 +1,12 @@
 #include <iostream>
 #include <fstream>
 #include <regex>
+#include <sstream>
 #include <Utils.h>
+#include <Benchmark.h>
+#include <DiracDiceEngine.h>
+#include <DiracDiceTable.h>
+#include <DeterministicDiceGame.h>
 
 // TODO: refactor, improve performance !!!!!!!!!!!
 
@@ -49,7 +54,7 @@ unsigned players_turn(unsigned position, Dice& dice) {
     return move_forward(position, dice_roll_result);
 }
 
-unsigned solve_part_one(unsigned first_player_position, unsigned second_player_position) {
+unsigned long long simulate_deterministic_game(unsigned first_player_position, unsigned second_player_position, unsigned winning_score) {
     auto deterministic_dice = [next = 1]() mutable {
         int current = next;
         next = (next % 100 + 1);
@@ -58,7 +63,7 @@ unsigned solve_part_one(unsigned first_player_position, unsigned second_player_p
     std::vector<Player> players {{first_player_position, 0}, {second_player_position, 0}};
     unsigned current_player_index = 0;
     unsigned number_of_dice_rolls = 0;
-    while(players.at(0).score < 1000 && players.at(1).score < 1000) {
+    while(players.at(0).score < winning_score && players.at(1).score < winning_score) {
         Player& current_player = players.at(current_player_index);
         current_player.position = players_turn(current_player.position, deterministic_dice);
         current_player.score += current_player.position;
@@ -66,102 +71,90 @@ unsigned solve_part_one(unsigned first_player_position, unsigned second_player_p
         current_player_index = (current_player_index + 1) % 2;
     }
     unsigned smaller_score = std::min(players.at(0).score, players.at(1).score);
-    return number_of_dice_rolls * smaller_score;
+    return static_cast<unsigned long long>(number_of_dice_rolls) * smaller_score;
 }
 
-std::vector<unsigned> generate_triple_dice_roll_scores() {
-    std::vector<unsigned> outcome{};
-    for(unsigned i = 1; i <= 3; ++i) {
-        for(unsigned j = 1; j <= 3; ++j) {
-            for(unsigned k = 1; k <= 3; ++k) {
-                outcome.emplace_back(i + j + k);
-            }
-        }
-    }
-    return outcome;
+unsigned long long solve_part_one(unsigned first_player_position, unsigned second_player_position) {
+    return DeterministicDiceGame{first_player_position, second_player_position}.play(1000);
 }
 
-struct GameState {
-    unsigned first_player_score = 0;
-    unsigned first_player_position = 0;
-    unsigned second_player_score = 0;
-    unsigned second_player_position = 0;
-
-    [[nodiscard]] unsigned get_score(unsigned index) const {
-        return index == 0 ? first_player_score : second_player_score;
-    }
-
-    void set_score(unsigned index, unsigned value) {
-        if(index == 0) {
-            first_player_score = value;
-        }
-        else {
-            second_player_score = value;
-        }
-    }
-
-    [[nodiscard]] unsigned get_position(unsigned index) const {
-        return index == 0 ? first_player_position : second_player_position;
-    }
+long long solve_part_two(unsigned first_player_position, unsigned second_player_position) {
+    DiracDiceEngine engine{};
+    const auto wins = engine.count_wins(first_player_position, second_player_position);
+    return static_cast<long long>(std::max(wins[0], wins[1]));
+}
 
-    void set_position(unsigned index, unsigned value) {
-        if(index == 0) {
-            first_player_position = value;
-        }
-        else {
-            second_player_position = value;
-        }
+void report_dirac_dice_variants(unsigned first_player_position, unsigned second_player_position) {
+    for(const auto& [board_size, winning_score]: std::vector<std::pair<unsigned, unsigned>>{{10, 21}, {10, 28}, {20, 28}, {40, 28}}) {
+        DiracDiceEngine engine{board_size, winning_score};
+        DiracDiceEngine::Wins wins{};
+        double time = benchmark::measure_milliseconds([&]() { wins = engine.count_wins(first_player_position, second_player_position); });
+        std::cout << "Board size: " << board_size << ", winning score: " << winning_score << ", wins: " << wins[0] << " / " << wins[1]
+                  << ", time: " << time << " ms" << std::endl;
     }
-};
-
-bool operator==(const GameState& lhs, const GameState& rhs) {
-    return lhs.first_player_score == rhs.first_player_score &&
-           lhs.first_player_position == rhs.first_player_position &&
-           lhs.second_player_score == rhs.second_player_score &&
-           lhs.second_player_position == rhs.second_player_position;
 }
 
-struct GameStateHash {
-    std::size_t operator()(const GameState& game_state) const {
-        return game_state.first_player_score +
-               20 * game_state.first_player_position +
-               20 * 10 * game_state.second_player_score +
-               20 * 10 * 20 * game_state.second_player_position; // TODO: check if good hash
+void report_deterministic_game(unsigned first_player_position, unsigned second_player_position) {
+    const DeterministicDiceGame game{first_player_position, second_player_position};
+    std::cout << "Deterministic game period: " << game.get_rounds_in_period() << " rounds" << std::endl;
+    for(const unsigned winning_score: {1'000u, 100'000u, 10'000'000u}) {
+        unsigned long long simulated = 0;
+        unsigned long long skipped = 0;
+        double simulation_time = benchmark::measure_milliseconds([&]() {
+            simulated = simulate_deterministic_game(first_player_position, second_player_position, winning_score);
+        });
+        double skipping_time = benchmark::measure_milliseconds([&]() { skipped = game.play(winning_score); });
+        std::cout << "Winning score: " << winning_score << ", simulated: " << simulated << " in " << simulation_time
+                  << " ms, period skipping: " << skipped << " in " << skipping_time << " ms" << std::endl;
     }
-};
+    const unsigned long long large_winning_score = 1'000'000'000ULL;
+    unsigned long long result = 0;
+    double time = benchmark::measure_milliseconds([&]() { result = game.play(large_winning_score); });
+    std::cout << "Winning score: " << large_winning_score << ", period skipping: " << result << " in " << time << " ms" << std::endl;
+}
 
-long long solve_part_two(unsigned first_player_position, unsigned second_player_position) {
-    const auto possible_dice_roll_scores = generate_triple_dice_roll_scores();
-    std::unordered_map<GameState, long long, GameStateHash> unfinished_games_histogram;
-    unfinished_games_histogram[GameState{0, first_player_position, 0, second_player_position}] = 1;
-    unsigned current_player = 0;
-    std::unordered_map<GameState, long long, GameStateHash> new_histogram;
-    std::vector<long long> games_won_by_player{0, 0};
-    while(!unfinished_games_histogram.empty()) {
-        new_histogram.clear();
-        for(const auto&[game_state, count] : unfinished_games_histogram) {
-            for(const auto& dice_roll_score : possible_dice_roll_scores) {
-                unsigned new_position = move_forward(game_state.get_position(current_player), dice_roll_score);
-                unsigned new_score = game_state.get_score(current_player) + new_position;
-                if(new_score >= 21) {
-                    games_won_by_player.at(current_player) += count;
-                    continue;
-                }
-                GameState new_game_state = game_state;
-                new_game_state.set_position(current_player, new_position);
-                new_game_state.set_score(current_player, new_score);
-                new_histogram[new_game_state] += count;
+void report_dirac_dice_table() {
+    DiracDiceTable table{};
+    double build_time = benchmark::measure_milliseconds([&]() { table = DiracDiceTable{}; });
+    DiracDiceEngine engine{};
+    unsigned mismatches = 0;
+    double lookup_time = benchmark::measure_milliseconds([&]() {
+        for(unsigned first_position = 1; first_position <= table.get_board_size(); ++first_position) {
+            for(unsigned second_position = 1; second_position <= table.get_board_size(); ++second_position) {
+                mismatches += table.wins(first_position, second_position) != engine.count_wins(first_position, second_position);
             }
         }
-        current_player = (current_player + 1) % 2;
-        unfinished_games_histogram = new_histogram;
+    });
+    std::cout << "Dirac dice table build time: " << build_time << " ms, all starting positions checked against the engine in "
+              << lookup_time << " ms, mismatches: " << mismatches << std::endl;
+    std::stringstream blob{};
+    table.save(blob);
+    const std::size_t blob_size = blob.str().size();
+    DiracDiceTable loaded_table{};
+    double load_time = benchmark::measure_milliseconds([&]() { loaded_table = DiracDiceTable::load(blob); });
+    std::cout << "Saved table size: " << blob_size << " bytes, load time: " << load_time << " ms, loaded table matches: "
+              << std::boolalpha << (loaded_table.wins(4, 8) == table.wins(4, 8)) << std::endl;
+    for(const auto& [winning_score, die_sides]: std::vector<std::pair<unsigned, unsigned>>{{21, 2}, {30, 2}, {10, 4}, {21, 4}}) {
+        std::cout << "Winning score: " << winning_score << ", die sides: " << die_sides;
+        try {
+            DiracDiceTable::Wins wins{};
+            double time = benchmark::measure_milliseconds([&]() { wins = DiracDiceTable{10, winning_score, die_sides}.wins(4, 8); });
+            std::cout << ", wins from 4 / 8: " << wins[0] << " / " << wins[1] << ", time: " << time << " ms" << std::endl;
+        }
+        catch(const std::overflow_error& error) {
+            std::cout << ", " << error.what() << std::endl;
+        }
     }
-    return std::max(games_won_by_player.at(0), games_won_by_player.at(1));
 }
 
-int main() {
+int main(int argc, char** argv) {
     const auto[first_player_position, second_player_position] = read_puzzle_input("input.txt");
     std::cout << "Part 1: " << solve_part_one(first_player_position, second_player_position) << std::endl;
     std::cout << "Part 2: " << solve_part_two(first_player_position, second_player_position) << std::endl;
+    if(benchmark::is_requested(argc, argv)) {
+        report_deterministic_game(first_player_position, second_player_position);
+        report_dirac_dice_variants(first_player_position, second_player_position);
+        report_dirac_dice_table();
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <bit>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+#include <ThreadPool.h>
+
+enum class SeafloorState {
+    EAST_MOVING_SEA_CUCUMBER,
+    SOUTH_MOVING_SEA_CUCUMBER,
+    NOTHING
+};
+
+// The seafloor is kept as two bitplanes, one per herd, every row packed into 64-bit words.
+// Only rows changed by the previous step (and for the south herd the rows above them) are examined,
+// a row nothing happened to can not change on its own.
+// Rows can be split into bands processed by a thread pool, copies of the herds share the pool.
+class SeaCucumberHerds {
+public:
+
+    SeaCucumberHerds(const std::vector<SeafloorState>& seafloor, unsigned width, unsigned height, unsigned number_of_threads = 1)
+        : seafloor_width{width}, seafloor_height{height}, words_per_row{(width + WORD_SIZE - 1) / WORD_SIZE},
+          thread_pool{number_of_threads > 1 ? std::make_shared<ThreadPool>(number_of_threads) : nullptr},
+          number_of_bands{std::max(std::min(height, std::max(number_of_threads, 1u) * BANDS_PER_THREAD), 1u)},
+          east_moving_herd(words_per_row * height, 0), south_moving_herd(words_per_row * height, 0),
+          south_movers(words_per_row * height, 0), east_movers_rows(words_per_row * number_of_bands, 0),
+          row_changed_in_previous_step(height, 1), row_changed_in_current_step(height, 0),
+          row_has_south_movers(height, 0), moved_cucumbers_in_bands(number_of_bands, 0) {
+        if(seafloor_width * seafloor_height != seafloor.size()) {
+            throw std::runtime_error{"Seafloor size does not match given width and height"};
+        }
+        for(unsigned y = 0; y < seafloor_height; ++y) {
+            for(unsigned x = 0; x < seafloor_width; ++x) {
+                const auto state = seafloor[y * seafloor_width + x];
+                const Word bit = Word{1} << (x % WORD_SIZE);
+                if(state == SeafloorState::EAST_MOVING_SEA_CUCUMBER) {
+                    row(east_moving_herd, y)[x / WORD_SIZE] |= bit;
+                }
+                else if(state == SeafloorState::SOUTH_MOVING_SEA_CUCUMBER) {
+                    row(south_moving_herd, y)[x / WORD_SIZE] |= bit;
+                }
+            }
+        }
+    }
+
+    unsigned move_herds() {
+        number_of_active_rows = std::count(std::begin(row_changed_in_previous_step), std::end(row_changed_in_previous_step), 1);
+        std::fill(std::begin(row_changed_in_current_step), std::end(row_changed_in_current_step), 0);
+        unsigned number_of_moved_cucumbers = 0;
+        number_of_moved_cucumbers += east_moving_herd_step();
+        number_of_moved_cucumbers += south_moving_herd_step();
+        std::swap(row_changed_in_previous_step, row_changed_in_current_step);
+        return number_of_moved_cucumbers;
+    }
+
+    [[nodiscard]]
+    inline unsigned number_of_rows_active_in_last_step() const {
+        return number_of_active_rows;
+    }
+
+    [[nodiscard]]
+    inline unsigned width() const {
+        return seafloor_width;
+    }
+
+    [[nodiscard]]
+    inline unsigned height() const {
+        return seafloor_height;
+    }
+
+    [[nodiscard]]
+    SeafloorState get(unsigned x, unsigned y) const {
+        const Word bit = Word{1} << (x % WORD_SIZE);
+        if(row(east_moving_herd, y)[x / WORD_SIZE] & bit) {
+            return SeafloorState::EAST_MOVING_SEA_CUCUMBER;
+        }
+        if(row(south_moving_herd, y)[x / WORD_SIZE] & bit) {
+            return SeafloorState::SOUTH_MOVING_SEA_CUCUMBER;
+        }
+        return SeafloorState::NOTHING;
+    }
+
+private:
+    using Word = std::uint64_t;
+    static constexpr unsigned WORD_SIZE = 64;
+    static constexpr unsigned BANDS_PER_THREAD = 4;
+
+    unsigned seafloor_width{};
+    unsigned seafloor_height{};
+    unsigned words_per_row{};
+    std::shared_ptr<ThreadPool> thread_pool{};
+    unsigned number_of_bands{};
+    std::vector<Word> east_moving_herd{};
+    std::vector<Word> south_moving_herd{};
+    std::vector<Word> south_movers{};
+    std::vector<Word> east_movers_rows{};
+    std::vector<char> row_changed_in_previous_step{};
+    std::vector<char> row_changed_in_current_step{};
+    std::vector<char> row_has_south_movers{};
+    std::vector<unsigned> moved_cucumbers_in_bands{};
+    unsigned number_of_active_rows{};
+
+    [[nodiscard]]
+    inline Word* row(std::vector<Word>& plane, unsigned y) const {
+        return plane.data() + y * words_per_row;
+    }
+
+    [[nodiscard]]
+    inline const Word* row(const std::vector<Word>& plane, unsigned y) const {
+        return plane.data() + y * words_per_row;
+    }
+
+    [[nodiscard]]
+    inline Word last_word_mask() const {
+        return seafloor_width % WORD_SIZE == 0 ? ~Word{0} : (Word{1} << (seafloor_width % WORD_SIZE)) - 1;
+    }
+
+    [[nodiscard]]
+    inline Word first_bit_of_row(const Word* east, const Word* south) const {
+        return (east[0] | south[0]) & 1;
+    }
+
+    [[nodiscard]]
+    inline unsigned next_row(unsigned y) const {
+        return y + 1 < seafloor_height ? y + 1 : 0;
+    }
+
+    [[nodiscard]]
+    inline unsigned previous_row(unsigned y) const {
+        return y > 0 ? y - 1 : seafloor_height - 1;
+    }
+
+    // Calls band_function(band_index, first_row, last_row) for every band and sums the per-band moved cucumbers.
+    template<typename BandFunction>
+    unsigned for_each_row_band(const BandFunction& band_function) {
+        const auto band_task = [this, &band_function](unsigned band_index) {
+            const unsigned first_row = band_index * seafloor_height / number_of_bands;
+            const unsigned last_row = (band_index + 1) * seafloor_height / number_of_bands;
+            moved_cucumbers_in_bands[band_index] = band_function(band_index, first_row, last_row);
+        };
+        if(thread_pool) {
+            thread_pool->run_and_wait(number_of_bands, band_task);
+        }
+        else {
+            for(unsigned band_index = 0; band_index < number_of_bands; ++band_index) {
+                band_task(band_index);
+            }
+        }
+        return std::accumulate(std::begin(moved_cucumbers_in_bands), std::end(moved_cucumbers_in_bands), 0u);
+    }
+
+    // Every east moving cucumber looks at the next cell of its row, the last cell wraps around to the first one.
+    unsigned east_moving_herd_step() {
+        return for_each_row_band([this](unsigned band_index, unsigned first_row, unsigned last_row) {
+            Word* movers = east_movers_rows.data() + band_index * words_per_row;
+            unsigned number_of_moved_cucumbers = 0;
+            for(unsigned y = first_row; y < last_row; ++y) {
+                if(!row_changed_in_previous_step[y]) {
+                    continue;
+                }
+                const unsigned moved_in_row = move_east_moving_herd_in_row(row(east_moving_herd, y), row(south_moving_herd, y), movers);
+                row_changed_in_current_step[y] |= moved_in_row > 0;
+                number_of_moved_cucumbers += moved_in_row;
+            }
+            return number_of_moved_cucumbers;
+        });
+    }
+
+    unsigned move_east_moving_herd_in_row(Word* east, const Word* south, Word* movers) const {
+        const unsigned last_word = words_per_row - 1;
+        const unsigned last_bit = (seafloor_width - 1) % WORD_SIZE;
+        unsigned number_of_moved_cucumbers = 0;
+        for(unsigned w = 0; w < words_per_row; ++w) {
+            const Word occupied = east[w] | south[w];
+            const Word next_occupied = w < last_word ? (east[w + 1] | south[w + 1]) << (WORD_SIZE - 1) : 0;
+            Word occupied_to_the_east = (occupied >> 1) | next_occupied;
+            if(w == last_word) {
+                occupied_to_the_east |= first_bit_of_row(east, south) << last_bit;
+            }
+            movers[w] = east[w] & ~occupied_to_the_east;
+            number_of_moved_cucumbers += std::popcount(movers[w]);
+        }
+        Word carry = (movers[last_word] >> last_bit) & 1;
+        for(unsigned w = 0; w < words_per_row; ++w) {
+            const Word next_carry = movers[w] >> (WORD_SIZE - 1);
+            east[w] = (east[w] & ~movers[w]) | (movers[w] << 1) | carry;
+            carry = next_carry;
+        }
+        east[last_word] &= last_word_mask();
+        return number_of_moved_cucumbers;
+    }
+
+    // Every south moving cucumber looks at the cell below, the last row wraps around to the first one.
+    // Movers are found for all bands first, then every row takes in the movers of the row above it.
+    unsigned south_moving_herd_step() {
+        const unsigned number_of_moved_cucumbers = for_each_row_band([this](unsigned, unsigned first_row, unsigned last_row) {
+            unsigned moved_in_band = 0;
+            for(unsigned y = first_row; y < last_row; ++y) {
+                const unsigned next_y = next_row(y);
+                row_has_south_movers[y] = 0;
+                if(!row_changed_in_previous_step[y] && !row_changed_in_previous_step[next_y]) {
+                    continue;
+                }
+                const unsigned moved_from_row = find_south_movers_in_row(y, next_y);
+                row_has_south_movers[y] = moved_from_row > 0;
+                moved_in_band += moved_from_row;
+            }
+            return moved_in_band;
+        });
+        for_each_row_band([this](unsigned, unsigned first_row, unsigned last_row) {
+            for(unsigned y = first_row; y < last_row; ++y) {
+                const unsigned previous_y = previous_row(y);
+                if(!row_has_south_movers[y] && !row_has_south_movers[previous_y]) {
+                    continue;
+                }
+                Word* south = row(south_moving_herd, y);
+                const Word* leaving = row(south_movers, y);
+                const Word* arriving = row(south_movers, previous_y);
+                const Word leaving_mask = row_has_south_movers[y] ? ~Word{0} : 0;
+                const Word arriving_mask = row_has_south_movers[previous_y] ? ~Word{0} : 0;
+                for(unsigned w = 0; w < words_per_row; ++w) {
+                    south[w] = (south[w] & ~(leaving[w] & leaving_mask)) | (arriving[w] & arriving_mask);
+                }
+                row_changed_in_current_step[y] = 1;
+            }
+            return 0u;
+        });
+        return number_of_moved_cucumbers;
+    }
+
+    unsigned find_south_movers_in_row(unsigned y, unsigned next_y) {
+        const Word* south = row(south_moving_herd, y);
+        const Word* next_east = row(east_moving_herd, next_y);
+        const Word* next_south = row(south_moving_herd, next_y);
+        Word* movers = row(south_movers, y);
+        unsigned number_of_moved_cucumbers = 0;
+        for(unsigned w = 0; w < words_per_row; ++w) {
+            movers[w] = south[w] & ~(next_east[w] | next_south[w]);
+            number_of_moved_cucumbers += std::popcount(movers[w]);
+        }
+        return number_of_moved_cucumbers;
+    }
+};
@@ -2,67 +2,8 @@
 #include <fstream>
 #include <vector>
 #include <Utils.h>
-
-enum class SeafloorState {
-    EAST_MOVING_SEA_CUCUMBER,
-    SOUTH_MOVING_SEA_CUCUMBER,
-    NOTHING
-};
-
-class SeaCucumberHerds {
-public:
-
-    SeaCucumberHerds(std::vector<SeafloorState> seafloor, unsigned width, unsigned height)
-        : seafloor_state{std::move(seafloor)}, seafloor_width{width}, seafloor_height{height} {
-        if(seafloor_width * seafloor_height != seafloor_state.size()) {
-            throw std::runtime_error{"Seafloor size does not match given width and height"};
-        }
-    }
-
-    unsigned move_herds() {
-        unsigned number_of_moved_cucumbers = 0;
-        number_of_moved_cucumbers += east_moving_herd_step();
-        number_of_moved_cucumbers += south_moving_herd_step();
-        return number_of_moved_cucumbers;
-    }
-
-private:
-    std::vector<SeafloorState> seafloor_state{};
-    unsigned seafloor_width{};
-    unsigned seafloor_height{};
-
-    unsigned east_moving_herd_step() {
-        const auto next_index_calculator = [width = seafloor_width](unsigned cucumber_index) {
-            return ((cucumber_index + 1) % width == 0) ? cucumber_index + 1 - width : cucumber_index + 1;
-        };
-        return move_herd_one_step(SeafloorState::EAST_MOVING_SEA_CUCUMBER, next_index_calculator);
-    }
-
-    unsigned south_moving_herd_step() {
-        const auto next_index_calculator = [height = seafloor_height, width = seafloor_width](unsigned cucumber_index) {
-            return ((cucumber_index + width) < width * height) ? cucumber_index + width : (cucumber_index % width);
-        };
-        return move_herd_one_step(SeafloorState::SOUTH_MOVING_SEA_CUCUMBER, next_index_calculator);
-    }
-
-    template<typename IndexCalculator>
-    unsigned move_herd_one_step(const SeafloorState& herd_type, const IndexCalculator& next_index_calculator) {
-        unsigned number_of_moved_cucumbers = 0;
-        std::vector<SeafloorState> new_floor_state = seafloor_state;
-        for(unsigned i = 0; i < seafloor_state.size(); ++i) {
-            if(seafloor_state.at(i) == herd_type) {
-                unsigned next_index = next_index_calculator(i);
-                if(seafloor_state.at(next_index) == SeafloorState::NOTHING) {
-                    new_floor_state.at(i) = SeafloorState::NOTHING;
-                    new_floor_state.at(next_index) = herd_type;
-                    ++number_of_moved_cucumbers;
-                }
-            }
-        }
-        seafloor_state = new_floor_state;
-        return number_of_moved_cucumbers;
-    }
-};
+#include <Benchmark.h>
+#include <SeaCucumberHerds.h>
 
 SeafloorState parse_seafloor_state(const char state) {
     switch (state) {
@@ -103,8 +44,59 @@ unsigned solve_part_one(SeaCucumberHerds herds) {
     return number_of_steps + 1;
 }
 
-int main() {
+void report_active_rows_per_step(SeaCucumberHerds herds) {
+    unsigned number_of_moved_cucumbers = 0;
+    unsigned step = 0;
+    do {
+        number_of_moved_cucumbers = herds.move_herds();
+        ++step;
+        std::cout << "Step " << step << ": " << herds.number_of_rows_active_in_last_step() << " active rows, "
+                  << number_of_moved_cucumbers << " moved cucumbers" << std::endl;
+    } while(number_of_moved_cucumbers != 0);
+}
+
+SeaCucumberHerds tile_seafloor(const SeaCucumberHerds& herds, unsigned number_of_tiles, unsigned number_of_threads) {
+    const unsigned tiled_width = herds.width() * number_of_tiles;
+    const unsigned tiled_height = herds.height() * number_of_tiles;
+    std::vector<SeafloorState> tiled_seafloor{};
+    tiled_seafloor.reserve(tiled_width * tiled_height);
+    for(unsigned y = 0; y < tiled_height; ++y) {
+        for(unsigned x = 0; x < tiled_width; ++x) {
+            tiled_seafloor.emplace_back(herds.get(x % herds.width(), y % herds.height()));
+        }
+    }
+    return {tiled_seafloor, tiled_width, tiled_height, number_of_threads};
+}
+
+void report_parallel_speedup(const SeaCucumberHerds& herds) {
+    constexpr unsigned NUMBER_OF_STEPS = 50;
+    std::vector<unsigned> expected_moves{};
+    double single_thread_time = 0.0;
+    for(unsigned number_of_threads = 1; number_of_threads <= std::thread::hardware_concurrency(); number_of_threads *= 2) {
+        auto tiled_herds = tile_seafloor(herds, 20, number_of_threads);
+        std::vector<unsigned> moves{};
+        double time = benchmark::measure_milliseconds([&]() {
+            for(unsigned step = 0; step < NUMBER_OF_STEPS; ++step) {
+                moves.emplace_back(tiled_herds.move_herds());
+            }
+        });
+        if(number_of_threads == 1) {
+            expected_moves = moves;
+            single_thread_time = time;
+        }
+        else if(moves != expected_moves) {
+            throw std::runtime_error{"Parallel result differs from the serial one"};
+        }
+        std::cout << "Threads: " << number_of_threads << ", time: " << time << " ms, speedup: " << single_thread_time / time << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
     const auto puzzle_input = read_puzzle_input("input.txt");
     std::cout << "Part 1: " << solve_part_one(puzzle_input) << std::endl;
+    if(benchmark::is_requested(argc, argv)) {
+        report_active_rows_per_step(puzzle_input);
+        report_parallel_speedup(puzzle_input);
+    }
     return 0;
 }
\ No newline at end of file